@@ -53,6 +53,36 @@ public:
 
 		return true;
 	}
+
+	//
+	// Write values that are held by column, columns[i] holds the values for headers[i]
+	// and all of the columns are the same length
+	//
+	static bool writeColumns(std::ostream& strm, const QVector<QString>& headers, const QVector<QVector<double>>& columns)
+	{
+		for (int i = 0; i < headers.size(); i++)
+		{
+			strm << '"' << headers[i].toStdString() << '"';
+			if (i != headers.size() - 1)
+				strm << ",";
+		}
+		strm << std::endl;
+
+		int rows = (columns.size() > 0) ? columns[0].size() : 0;
+		for (int row = 0; row < rows; row++)
+		{
+			for (int i = 0; i < columns.size(); i++)
+			{
+				if (i != 0)
+					strm << ",";
+
+				strm << columns[i][row];
+			}
+			strm << std::endl;
+		}
+
+		return true;
+	}
 };
 
 
@@ -0,0 +1,56 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include <atomic>
+#include <exception>
+
+//
+// Thrown from inside the generators when the cancel token for the
+// generation has been set.  The Generator catches this and abandons
+// the trajectory group.
+//
+class GenerationCanceled : public std::exception
+{
+public:
+	const char* what() const noexcept override {
+		return "trajectory generation canceled";
+	}
+};
+
+class CancelToken
+{
+public:
+	CancelToken() : canceled_(false) {
+	}
+
+	void cancel() {
+		canceled_.store(true, std::memory_order_relaxed);
+	}
+
+	bool isCanceled() const {
+		return canceled_.load(std::memory_order_relaxed);
+	}
+
+	void throwIfCanceled() const {
+		if (isCanceled()) {
+			throw GenerationCanceled();
+		}
+	}
+
+private:
+	std::atomic<bool> canceled_;
+};
@@ -26,6 +26,24 @@ std::shared_ptr<PathConstraint> CentripetalConstraint::clone(std::shared_ptr<Rob
 	return ret;
 }
 
+void CentripetalConstraint::applyMaxVelocity(const ConstraintPoints& points, QVector<double>& limits, std::shared_ptr<RobotParams> robot)
+{
+	//
+	// The units are the same for every point, so the conversions are found once and the
+	// loop below only multiplies
+	//
+	double weight = UnitConverter::convert(robot->getRobotWeight(), robot->getWeightUnit(), UnitConverter::Unit::Kilograms);
+	double tometers = UnitConverter::factor(path()->unit(), UnitConverter::Unit::Meters);
+
+	const double* curvature = points.curvatures.constData();
+	double* limit = limits.data();
+	int count = points.curvatures.size();
+
+	for (int i = 0; i < count; i++) {
+		limit[i] = std::min(limit[i], maxVelocity(curvature[i], weight, tometers));
+	}
+}
+
 void CentripetalConstraint::setMaxCenForce(double c, bool undoentry) {
 	if (undoentry) {
 		path()->beforeConstraintChanged(std::make_shared<UndoChangeCentripetalForceConstraint>(maxcen_, shared_from_this()));
@@ -47,38 +47,14 @@ public:
 		// The conastraint value is in Newtons.  To compute a velocity, we need to convert the units to the
 		// length and mass units being used by the user.
 		//
+		double weight = UnitConverter::convert(robot->getRobotWeight(), robot->getWeightUnit(), UnitConverter::Unit::Kilograms);
+		double tometers = UnitConverter::factor(path()->unit(), UnitConverter::Unit::Meters);
 
-		if (std::abs(state.curvature()) < 0.0001) {
-			//
-			// If there is not curvature, there is not centripal force and therefore there is no
-			// limit on the velocity 
-			//
-			return std::numeric_limits<double>::max();
-		}
-
-		//
-		// Get the weight and convert to kgrams
-		//
-		double weight = UnitConverter::convert(robot->getRobotWeight(), robot->getWeightUnits(), "kg");
-
-		//
-		// Get the radius of the curvature in meters
-		//
-		double radius = UnitConverter::convert(1.0 / state.curvature(), path()->units(), "m");
-
-		//
-		// Compute the velocity in meters per second
-		//
-		double vel = std::sqrt(std::abs(maxcen_ * radius / weight));
-
-		//
-		// Convert the velocity back to the units of the path
-		//
-		vel = UnitConverter::convert(vel, "m", path()->units());
-
-		return vel;
+		return maxVelocity(state.curvature(), weight, tometers);
 	}
 
+	void applyMaxVelocity(const ConstraintPoints& points, QVector<double>& limits, std::shared_ptr<RobotParams> robot) override;
+
 	MinMaxAcceleration getMinMaxAccel(const Pose2dWithTrajectory& state, double velocity, std::shared_ptr<RobotParams> robot) override {
 		(void)state;
 		(void)velocity;
@@ -87,7 +63,7 @@ public:
 		return acc;
 	}
 
-	void convert(const QString& from, const QString& to) override {
+	void convert(UnitConverter::Unit from, UnitConverter::Unit to) override {
 	}
 
 	QString toString() const {
@@ -120,6 +96,31 @@ public:
 		return std::make_shared<CentripetalConstraint>(path, maxcen);
 	}
 
+private:
+	//
+	// The maximum velocity, in the units of the path, for a point with the given curvature.  The
+	// weight is in kilograms, and tometers converts the length units of the path to meters.
+	//
+	double maxVelocity(double curvature, double weight, double tometers) const {
+		if (std::abs(curvature) < 0.0001) {
+			//
+			// If there is not curvature, there is not centripal force and therefore there is no
+			// limit on the velocity 
+			//
+			return std::numeric_limits<double>::max();
+		}
+
+		//
+		// Get the radius of the curvature in meters
+		//
+		double radius = tometers / curvature;
+
+		//
+		// Compute the velocity in meters per second and convert it back to the units of the path
+		//
+		return std::sqrt(std::abs(maxcen_ * radius / weight)) / tometers;
+	}
+
 private:
 	double maxcen_;
 };
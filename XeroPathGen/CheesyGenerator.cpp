@@ -24,12 +24,17 @@
 #include "RobotParams.h"
 #include "TrapezoidalProfile.h"
 #include "DistanceVelocityConstraint.h"
+#include "MathUtils.h"
+#include <algorithm>
 #include <cmath>
 
 CheesyGenerator::CheesyGenerator(const QString &logfile, QMutex& loglock, int which, double diststep, double timestep, double maxdx, double maxdy, double maxtheta, std::shared_ptr<RobotParams> robot, bool xeromode)
 		: GeneratorBase(logfile, loglock, which, diststep, timestep, maxdx, maxdy, maxtheta, robot)
 {
 	xeromode_ = xeromode;
+	preview_ = false;
+	rotation_hint_ = -1.0;
+	rotation_percent_ = -1.0;
 }
 
 CheesyGenerator::~CheesyGenerator()
@@ -43,42 +48,73 @@ CheesyGenerator::generateSwervePerWaypointRotate(std::shared_ptr<RobotPath> path
 	std::shared_ptr<PathTrajectory> traj;
 
 	logMessage(path->fullname() + ": generating splines");
-	QVector<std::shared_ptr<SplinePair>> splines = generateSplines(path->waypoints());
-	QVector<double> dists = TrajectoryUtils::getDistancesForSplines(splines);
+	const QVector<double>& dists = waypointDistances(path);
 	assert(dists.size() == path->waypoints().size());
-	bool generating = true;
 
 	QVector<std::shared_ptr<PathConstraint>> extras;
-	QVector<double> percents;
+	QVector<std::shared_ptr<DistanceVelocityConstraint>> limits;
+	QVector<double> percents, lo, hi;
 
+	//
+	// Each segment gives a share of the velocity to the linear motion and leaves the rest
+	// for the rotation.  Raising the share of any segment only makes the robot faster, and
+	// the rotations harder, so each segment has a largest share that works.  The shares of
+	// all of the segments are bisected together, checking each segment against the
+	// trajectory generated with the current shares.  The estimate from solveSegmentPercent()
+	// is the low end of each bracket to start with, and full velocity is tried first.  If
+	// the low end of a segment stops working, because a neighbor was raised or because the
+	// estimate was wrong, its bracket is opened up below it.
+	//
 	for (int i = 0; i < path->size() - 1; i++) {
-		percents.push_back(1);
+		lo.push_back(solveSegmentPercent(path, dists, i));
+		hi.push_back(1.0 + PercentTolerance);
+		percents.push_back(1.0);
+	}
+
+	//
+	// One velocity limit per segment, made once and set to the segment's share of the
+	// velocity before each pass
+	//
+	for (int i = 0; i < path->size() - 1; i++) {
+		auto c = std::make_shared<DistanceVelocityConstraint>(path, dists[i], dists[i + 1], path->params().maxVelocity());
+		limits.push_back(c);
+		extras.push_back(c);
 	}
 
 	int iteration = 1;
 	bool running = true;
 	while (running) {
+		checkCanceled();
 		logMessage(path->fullname() + ": iteration " + QString::number(iteration++));
 
+		bool converged = true;
+		for (int i = 0; i < percents.size(); i++) {
+			if (lo[i] >= 1.0 || hi[i] - lo[i] <= PercentTolerance) {
+				percents[i] = lo[i];
+			}
+			else {
+				percents[i] = (hi[i] > 1.0) ? 1.0 : (lo[i] + hi[i]) / 2.0;
+				converged = false;
+			}
+		}
+
 		logtext.clear();
 		for (double d : percents) {
 			if (logtext.length() > 0) {
 				logtext += ", ";
 			}
-			logtext += QString::number(d, 'f', 2);
+			logtext += QString::number(d, 'f', 3);
 		}
 		logMessage(path->fullname() + ": per seg percentages: " + logtext);
 
-		running = false;
+		running = !converged;
 
 		//
 		// Generate the linear trajectory based on the percent of robot velocity used for each
 		// of the segments between the various waypoints
 		//
-		extras.clear();
 		for (int i = 0; i < path->size() - 1; i++) {
-			auto c = std::make_shared<DistanceVelocityConstraint>(path, dists[i], dists[i + 1], path->params().maxVelocity() * percents[i]);
-			extras.push_back(c);
+			limits[i]->setLimit(path->params().maxVelocity() * percents[i]);
 		}
 
 		traj = generateInternal(path, extras);
@@ -87,13 +123,13 @@ CheesyGenerator::generateSwervePerWaypointRotate(std::shared_ptr<RobotPath> path
 		}
 
 		//
-		// Now evaluate if any rotation requested is feasible.  If not, we lower the percentage of velocity for
-		// any given segment available to the linear trajectory to reserve more for the rotation.
+		// Now evaluate if any rotation requested is feasible, and narrow the bracket of
+		// each segment by the result
 		//
-		QVector<bool> status;
-
 		for (int i = 0; i < path->size() - 1; i++)
 		{
+			checkCanceled();
+
 			double startTime, endTime;
 			int startIndex, endIndex;
 			double startRot = path->getPoint(i).getSwrot().toDegrees();
@@ -109,6 +145,8 @@ CheesyGenerator::generateSwervePerWaypointRotate(std::shared_ptr<RobotPath> path
 				return nullptr;
 			}
 			startIndex = traj->getIndex(startTime);
+			if (startIndex == -1)
+				return nullptr;
 
 			if (!traj->getTimeForDistance(dists[i + 1], endTime))
 			{
@@ -119,6 +157,8 @@ CheesyGenerator::generateSwervePerWaypointRotate(std::shared_ptr<RobotPath> path
 			}
 
 			endIndex = traj->getIndex(endTime);
+			if (endIndex == -1)
+				return nullptr;
 
 			if (traj->size() - endIndex < 5) {
 				//
@@ -134,62 +174,229 @@ CheesyGenerator::generateSwervePerWaypointRotate(std::shared_ptr<RobotPath> path
 			// We now need the trajectory points for the times range
 			//
 
-			if (!modifySegmentForRotation(path, traj, 1.0 - percents[i], startIndex, endIndex, startRot, startRotVel, endRot, endRotVel))
+			if (modifySegmentForRotation(path, traj, 1.0 - percents[i], startIndex, endIndex, startRot, startRotVel, endRot, endRotVel))
 			{
-				percents[i] -= 0.01;
+				lo[i] = percents[i];
+			}
+			else
+			{
+				if (percents[i] <= lo[i]) {
+					lo[i] = percents[i] / 2.0;
+				}
+				hi[i] = percents[i];
 				running = true;
 
-				if (percents[i] <= 0.0) {
+				if (hi[i] <= PercentTolerance) {
 					//
 					// A single segment cannot reach the desired goal
 					//
 					return nullptr;
 				}
-				status.push_back(false);
-			}
-			else
-			{
-				status.push_back(true);
-				status.push_back(true);
 			}
+		}
+	}
 
-			logtext.clear();
-			for (bool b : status) {
-				if (logtext.length() > 0) {
-					logtext += ", ";
-				}
+	return traj;
+}
 
-				logtext += (b ? "success" : "failed");
-			}
+double CheesyGenerator::segmentTimeBound(std::shared_ptr<RobotPath> path, const QVector<double>& dists, int seg, double percent)
+{
+	//
+	// The fastest the robot could possibly cover the segment.  At any distance along the path,
+	// the velocity is limited by the velocity cap for the segment, by accelerating from the
+	// start velocity, and by being able to decelerate to the end velocity.  Anything else
+	// (curvature, user constraints, other segments) only slows the robot down further.  The
+	// midpoint rule underestimates the time, as 1/v is convex, so this stays a lower bound.
+	//
+	const PathParameters& params = path->params();
+	const int steps = 64;
+
+	double start = dists[seg];
+	double length = dists[seg + 1] - dists[seg];
+	double total = dists.back();
+	double vmax = params.maxVelocity() * percent;
+	double accel = params.maxAccel();
+	double v0 = params.startVelocity();
+	double v1 = params.endVelocity();
+
+	if (length <= 0.0) {
+		return 0.0;
+	}
+
+	double ds = length / steps;
+	double time = 0.0;
+
+	for (int i = 0; i < steps; i++) {
+		double s = start + (i + 0.5) * ds;
+		double v = std::min(vmax, std::sqrt(v0 * v0 + 2.0 * accel * s));
+		v = std::min(v, std::sqrt(v1 * v1 + 2.0 * accel * std::max(0.0, total - s)));
+
+		if (v <= 0.0) {
+			return std::numeric_limits<double>::infinity();
+		}
+
+		time += ds / v;
+	}
+
+	return time;
+}
+
+double CheesyGenerator::solveSegmentPercent(std::shared_ptr<RobotPath> path, const QVector<double>& dists, int seg)
+{
+	double startRot = path->getPoint(seg).getSwrot().toDegrees();
+	double endRot = path->getPoint(seg + 1).getSwrot().toDegrees();
+	double startRotVel = path->getPoint(seg).getSwrotVelocity();
+	double endRotVel = path->getPoint(seg + 1).getSwrotVelocity();
+
+	//
+	// Giving more to the linear motion shortens the segment and leaves less for the
+	// rotation, which lengthens the rotation.  So the feasible percentages are all those
+	// below a single threshold, which is found by bisection.
+	//
+	auto feasible = [&](double percent) {
+		return rotationTime(path, 1.0 - percent, startRot, startRotVel, endRot, endRotVel) <= segmentTimeBound(path, dists, seg, percent);
+	};
+
+	if (feasible(1.0)) {
+		return 1.0;
+	}
+
+	double lo = 0.0;
+	double hi = 1.0;
+	while (hi - lo > PercentTolerance) {
+		double mid = (lo + hi) / 2.0;
+		if (feasible(mid)) {
+			lo = mid;
+		}
+		else {
+			hi = mid;
 		}
 	}
 
+	logMessage(path->fullname() + ": segment " + QString::number(seg) + " solved percentage " + QString::number(lo, 'f', 3));
+
+	return std::max(lo, 0.01);
+}
+
+std::shared_ptr<PathTrajectory>
+CheesyGenerator::generateSingleRotate(std::shared_ptr<RobotPath> path, double percent, QVector<std::shared_ptr<PathConstraint>>& extras)
+{
+	checkCanceled();
+
+	auto traj = generateInternal(path, extras);
+	if (traj == nullptr || !modifyForRotation(path, traj, 1.0 - percent)) {
+		return nullptr;
+	}
+
 	return traj;
 }
 
 std::shared_ptr<PathTrajectory>
 CheesyGenerator::generateSwerveSingleRotate(std::shared_ptr<RobotPath> path)
+{
+	std::shared_ptr<PathTrajectory> best;
+
+	//
+	// Giving less of the velocity to the linear motion makes the rotation easier, so there
+	// is a single percentage below which everything works.  The percentage is searched for
+	// on a grid of RotationSteps steps, by grid index.  lo is the largest index known to
+	// work (or zero) and hi is the smallest known to fail (or above the grid if none has
+	// failed yet).  The search ends when they are next to each other, and lo is then the
+	// last grid point below the threshold, no matter which points were tried to get there.
+	//
+	int lo = 0;
+	int hi = RotationSteps + 1;
+
+	//
+	// A single velocity limit is made for the search and set to each percentage tried
+	//
+	auto limit = std::make_shared<DistanceVelocityConstraint>(path, 0.0, std::numeric_limits<double>::max(), robotMaxVelocity());
+	QVector<std::shared_ptr<PathConstraint>> extras;
+	extras.push_back(limit);
+
+	auto attempt = [&](int step) {
+		double percent = static_cast<double>(step) / RotationSteps;
+		limit->setLimit(percent * robotMaxVelocity());
+
+		auto traj = generateSingleRotate(path, percent, extras);
+		if (traj != nullptr) {
+			best = traj;
+			lo = step;
+			return true;
+		}
+
+		hi = step;
+		return false;
+	};
+
+	//
+	// Start from where we ended up last time and try the grid points on either side of it.
+	// After a small edit this is usually all it takes, and otherwise the bracket is at
+	// least narrower.  As the answer does not depend on the points tried, the hint only
+	// changes how long the search takes, never what it finds.
+	//
+	if (rotation_hint_ > 0.0 && rotation_hint_ <= 1.0) {
+		int step = std::clamp(static_cast<int>(std::floor(rotation_hint_ * RotationSteps)), 1, RotationSteps);
+		if (attempt(step)) {
+			if (step < RotationSteps) {
+				attempt(step + 1);
+			}
+		}
+		else if (step > 1) {
+			attempt(step - 1);
+		}
+	}
+
+	while (hi - lo > 1) {
+		attempt((hi > RotationSteps) ? RotationSteps : (lo + hi) / 2);
+	}
+
+	double percent = static_cast<double>(lo) / RotationSteps;
+	logMessage(path->fullname() + ": single rotation percentage " + QString::number(percent, 'f', 3));
+
+	rotation_percent_ = (best == nullptr) ? -1.0 : percent;
+	return best;
+}
+
+std::shared_ptr<PathTrajectory>
+CheesyGenerator::generateSwervePreview(std::shared_ptr<RobotPath> path)
 {
 	std::shared_ptr<PathTrajectory> traj;
-	double percent = 1.0;
-	double maxvel = robotMaxVelocity();
 	QVector<std::shared_ptr<PathConstraint>> extras;
 
-	while (percent > 0.0)
-	{
-		extras.clear();
-		auto c = std::make_shared<DistanceVelocityConstraint>(path, 0.0, std::numeric_limits<double>::max(), percent * maxvel);
-		extras.push_back(c);
-		traj = generateInternal(path, extras);
+	traj = generateInternal(path, extras);
+	if (traj == nullptr) {
+		return traj;
+	}
+
+	//
+	// Rather than fitting a rotation profile to each segment, blend the swerve rotation
+	// linearly by distance between the waypoints.  The velocity of the path is not
+	// reduced to make room for the rotation, so this is only an approximation.
+	//
+	const QVector<double>& dists = waypointDistances(path);
+	assert(dists.size() == path->waypoints().size());
+
+	int seg = 0;
+	const QVector<double>& positions = traj->positions();
+	for (int i = 0; i < traj->size(); i++) {
+		double position = positions[i];
 
-		if (modifyForRotation(path, traj, 1.0 - percent)) {
-			break;
+		while (seg < path->size() - 2 && position > dists[seg + 1]) {
+			seg++;
 		}
 
-		percent -= 0.01;
+		double startRot = path->getPoint(seg).getSwrot().toDegrees();
+		double endRot = path->getPoint(seg + 1).getSwrot().toDegrees();
+		double len = dists[seg + 1] - dists[seg];
+		double percent = (len > 0.0) ? (position - dists[seg]) / len : 1.0;
+		percent = std::clamp(percent, 0.0, 1.0);
+
+		double angle = MathUtils::boundDegrees(startRot + MathUtils::boundDegrees(endRot - startRot) * percent);
+		traj->setSwrot(i, Rotation2d::fromDegrees(angle));
 	}
 
-	return (percent <= 0.0) ? nullptr : traj;
+	return traj;
 }
 
 std::shared_ptr<PathTrajectory>
@@ -205,7 +412,7 @@ CheesyGenerator::generateTankDrive(std::shared_ptr<RobotPath> path)
 	// heading so that it still represents the direction the robot is pointing
 	//
 	for (int i = 0; i < traj->size(); i++) {
-		(*traj)[i].pose().setSwrot((*traj)[i].rotation());
+		traj->setSwrot(i, Rotation2d(traj->headingCos()[i], traj->headingSin()[i], false));
 	}
 
 	return traj;
@@ -226,7 +433,10 @@ CheesyGenerator::generate(std::shared_ptr<RobotPath> path)
 		startmsg += ", drive = swerve";
 	}
 
-	if (xeromode_) {
+	if (preview_) {
+		startmsg += ", preview mode";
+	}
+	else if (xeromode_) {
 		startmsg += ", per waypoint rotation mode";
 	}
 	else {
@@ -244,6 +454,10 @@ CheesyGenerator::generate(std::shared_ptr<RobotPath> path)
 	{
 		traj = generateTankDrive(path);
 	}
+	else if (preview_)
+	{
+		traj = generateSwervePreview(path);
+	}
 	else
 	{
 		if (xeromode_) {
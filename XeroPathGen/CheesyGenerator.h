@@ -33,12 +33,53 @@ public:
 
 	std::shared_ptr<PathTrajectory> generate(std::shared_ptr<RobotPath> path);
 
+	//
+	// In preview mode the swerve generators skip the search for a velocity that
+	// leaves room for the requested rotations
+	//
+	void setPreview(bool b) {
+		preview_ = b;
+	}
+
+	//
+	// The percentage of velocity given to the linear motion in single rotation mode.  The
+	// hint, usually the value found the last time the path was generated, is tried first.
+	// It only narrows the search, the percentage found is the same without it.
+	//
+	void setRotationHint(double p) {
+		rotation_hint_ = p;
+	}
+
+	double rotationPercent() const {
+		return rotation_percent_;
+	}
+
 protected:
 	std::shared_ptr<PathTrajectory> generateSwerveSingleRotate(std::shared_ptr<RobotPath> path);
 	std::shared_ptr<PathTrajectory> generateSwervePerWaypointRotate(std::shared_ptr<RobotPath> path);
 	std::shared_ptr<PathTrajectory> generateTankDrive(std::shared_ptr<RobotPath> path);
+	std::shared_ptr<PathTrajectory> generateSwervePreview(std::shared_ptr<RobotPath> path);
+
+	double segmentTimeBound(std::shared_ptr<RobotPath> path, const QVector<double>& dists, int seg, double percent);
+	double solveSegmentPercent(std::shared_ptr<RobotPath> path, const QVector<double>& dists, int seg);
+
+	//
+	// The trajectory with the given percent of the velocity left to the linear motion.
+	// The caller sets the velocity limit for the percent in extras.
+	//
+	std::shared_ptr<PathTrajectory> generateSingleRotate(std::shared_ptr<RobotPath> path, double percent, QVector<std::shared_ptr<PathConstraint>>& extras);
+
+private:
+	// How closely the per segment velocity percentage is solved for
+	static constexpr double PercentTolerance = 0.001;
+
+	// The single rotation velocity percentage is searched for in steps of 1 / RotationSteps
+	static constexpr int RotationSteps = 128;
 
 private:
 	bool xeromode_;
+	bool preview_;
+	double rotation_hint_;
+	double rotation_percent_;
 };
 
@@ -99,11 +99,11 @@ void ConstraintEditorWindow::addDistanceVelocityConstraint()
 	Qt::WindowFlags flags;
 
 	QString label = "Velocity (" + path_->units() + "/s)";
-	double maxvel = UnitConverter::convert(10.0, "m", path()->units());
+	double maxvel = UnitConverter::convert(10.0, UnitConverter::Unit::Meters, path()->unit());
 	double velocity = QInputDialog::getDouble(this, "Enter Velocity Limit", label, 0.0, 0.0, maxvel, 3, &ok, flags, 0.01);
 
 	label = "After Distance (" + path_->units() + ")";
-	double maxdist = UnitConverter::convert(50.0, "m", path()->units());
+	double maxdist = UnitConverter::convert(50.0, UnitConverter::Unit::Meters, path()->unit());
 	double after = QInputDialog::getDouble(this, "Apply Velocity After Distance", label, 0.0, 0.0, maxdist, 3, &ok, flags, 0.01);
 	label = "Before Distance (" + path_->units() + ")";
 	double before = QInputDialog::getDouble(this, "Apply Velocity Before Distance", label, after, after, maxdist, 3, &ok, flags, 0.01);
@@ -140,12 +140,12 @@ void ConstraintEditorWindow::constraintDoubleClicked(QTreeWidgetItem* item, int
 	else {
 		std::shared_ptr<DistanceVelocityConstraint> dist = std::dynamic_pointer_cast<DistanceVelocityConstraint>(c);
 		if (dist != nullptr) {
-			double maxvel = UnitConverter::convert(10.0, "m", path()->units());
+			double maxvel = UnitConverter::convert(10.0, UnitConverter::Unit::Meters, path()->unit());
 			QString label = "Velocity (" + path_->units() + "/s)";
 			double velocity = QInputDialog::getDouble(this, "Enter Velocity Limit", label, dist->getVelocity(), 0.0, maxvel, 3, &ok, flags, 0.01);
 
 			label = "After Distance (" + path_->units() + ")";
-			double maxdist = UnitConverter::convert(50.0, "m", path()->units());
+			double maxdist = UnitConverter::convert(50.0, UnitConverter::Unit::Meters, path()->unit());
 			double after = QInputDialog::getDouble(this, "Apply Velocity After Distance", label, dist->getAfter(), 0.0, maxdist, 2, &ok, flags, 0.01);
 
 			label = "Before Distance (" + path_->units() + ")";
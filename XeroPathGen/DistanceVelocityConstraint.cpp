@@ -44,6 +44,20 @@ double DistanceVelocityConstraint::getMaxVelocity(const Pose2dWithTrajectory& st
 	return std::numeric_limits<double>::max();
 }
 
+void DistanceVelocityConstraint::applyMaxVelocity(const ConstraintPoints& points, QVector<double>& limits, std::shared_ptr<RobotParams> robot)
+{
+	(void)robot;
+
+	const double* pos = points.positions.constData();
+	double* limit = limits.data();
+	int count = points.positions.size();
+
+	for (int i = 0; i < count; i++) {
+		bool inside = pos[i] > after_distance_ && pos[i] < before_distance_;
+		limit[i] = inside ? std::min(limit[i], velocity_) : limit[i];
+	}
+}
+
 MinMaxAcceleration DistanceVelocityConstraint::getMinMaxAccel(const Pose2dWithTrajectory& state, double velocity, std::shared_ptr<RobotParams> robot)
 {
 	(void)velocity;
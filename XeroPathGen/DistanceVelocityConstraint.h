@@ -39,9 +39,10 @@ public:
 	}
 
 	double getMaxVelocity(const Pose2dWithTrajectory& state, std::shared_ptr<RobotParams> robot) override ;
+	void applyMaxVelocity(const ConstraintPoints& points, QVector<double>& limits, std::shared_ptr<RobotParams> robot) override;
 	MinMaxAcceleration getMinMaxAccel(const Pose2dWithTrajectory& state, double velocity, std::shared_ptr<RobotParams> robot) override ;
 
-	void convert(const QString& from, const QString& to) override {
+	void convert(UnitConverter::Unit from, UnitConverter::Unit to) override {
 		after_distance_ = UnitConverter::convert(after_distance_, from, to);
 		before_distance_ = UnitConverter::convert(before_distance_, from, to);
 		velocity_ = UnitConverter::convert(velocity_, from, to);
@@ -75,6 +76,14 @@ public:
 		return velocity_;
 	}
 
+	//
+	// Changes the velocity limit without an undo entry or telling the path.  This is for
+	// the constraints a generator makes for itself, which belong to no path being edited.
+	//
+	void setLimit(double velocity) {
+		velocity_ = velocity;
+	}
+
 	void setVelocity(double d, bool undoentry) {
 		if (undoentry) {
 			path()->beforePathChanged(std::make_shared< UndoDistanceVelocityConstraintChange>(velocity_, after_distance_, before_distance_, shared_from_this()));
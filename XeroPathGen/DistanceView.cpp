@@ -15,16 +15,21 @@
 //
 #include "DistanceView.h"
 #include "TrajectoryUtils.h"
+#include <cmath>
+#include <cassert>
 
 DistanceView::DistanceView(const QVector<Pose2dWithRotation>& points, double step)
 {
 	static const double kEpsilon = 1e-6;
 	double d;
 
+	distances_.reserve(points.size());
 	distances_.push_back(0.0);
 	for (int i = 1; i < points.size(); i++)
 		distances_.push_back(points[i].distance(points[i - 1]) + distances_[i - 1]);
 
+	points_.reserve(static_cast<int>(distances_.back() / step) + 1);
+
 	int index = 0;
 	for (d = 0.0; d <= distances_.back(); d += step)
 	{
@@ -37,12 +42,80 @@ DistanceView::DistanceView(const QVector<Pose2dWithRotation>& points, double ste
 	}
 
 	distances_.clear();
+	distances_.reserve(points_.size());
 	distances_.push_back(0.0);
 	for (int i = 1; i < points_.size(); i++)
 		distances_.push_back(points_[i].distance(points_[i - 1]) + distances_[i - 1]);
 
 	TrajectoryUtils::computeCurvature(points_);
+	findCurvatures();
+}
+
+DistanceView::DistanceView(const QVector<Pose2dWithRotation>& samples)
+{
+	points_ = samples;
+
+	distances_.reserve(points_.size());
+	distances_.push_back(0.0);
+	for (int i = 1; i < points_.size(); i++)
+		distances_.push_back(points_[i].distance(points_[i - 1]) + distances_[i - 1]);
+
+	TrajectoryUtils::computeCurvature(points_);
+	findCurvatures();
+}
+
+DistanceView::DistanceView(const QVector<Pose2dWithRotation>& samples, const QVector<double>& distances)
+{
+	assert(samples.size() == distances.size());
+
+	points_ = samples;
+	distances_ = distances;
+	findCurvatures();
+}
+
+void DistanceView::findCurvatures()
+{
+	curvatures_.resize(points_.size());
+	for (int i = 0; i < points_.size(); i++)
+		curvatures_[i] = points_[i].curvature();
+}
+
+QVector<Pose2dWithRotation> DistanceView::resample(const QVector<Pose2dWithRotation>& points, double step)
+{
+	static const double kEpsilon = 1e-6;
+	QVector<Pose2dWithRotation> results;
+	QVector<double> dists;
+
+	dists.reserve(points.size());
+	dists.push_back(0.0);
+	for (int i = 1; i < points.size(); i++)
+		dists.push_back(points[i].distance(points[i - 1]) + dists[i - 1]);
+
+	double length = dists.back();
+	if (length < kEpsilon) {
+		results.push_back(points.front());
+		results.push_back(points.back());
+		return results;
+	}
+
+	int count = static_cast<int>(std::ceil(length / step - kEpsilon));
+	double delta = length / count;
+
+	results.reserve(count + 1);
+
+	int index = 0;
+	for (int i = 0; i < count; i++)
+	{
+		double d = i * delta;
+		while (d > dists[index + 1] || dists[index + 1] - dists[index] < kEpsilon)
+			index++;
+
+		double percent = (d - dists[index]) / (dists[index + 1] - dists[index]);
+		results.push_back(points[index].interpolate(points[index + 1], percent));
+	}
+	results.push_back(points.back());
 
+	return results;
 }
 
 Pose2dWithRotation DistanceView::operator[](double dist) const
@@ -23,6 +23,25 @@ class DistanceView
 {
 public:
 	DistanceView(const QVector<Pose2dWithRotation>& points, double delta);
+
+	//
+	// A view of points that are already spaced by distance, see resample()
+	//
+	DistanceView(const QVector<Pose2dWithRotation>& samples);
+
+	//
+	// A view of points whose distance along the path and curvature are already known,
+	// so neither is estimated from the points
+	//
+	DistanceView(const QVector<Pose2dWithRotation>& samples, const QVector<double>& distances);
+
+	//
+	// Returns points evenly spaced by distance along the given points, including both
+	// ends.  The spacing is the largest that fits a whole number of times in the
+	// length and is no larger than step.
+	//
+	static QVector<Pose2dWithRotation> resample(const QVector<Pose2dWithRotation>& points, double step);
+
 	double length() const {
 		return distances_.back();
 	}
@@ -31,14 +50,29 @@ public:
 		return distances_[index];
 	}
 
+	//
+	// The distance along the path and the curvature at each point, one array per value
+	//
+	const QVector<double>& positions() const {
+		return distances_;
+	}
+
+	const QVector<double>& curvatures() const {
+		return curvatures_;
+	}
+
 	Pose2dWithRotation operator[](double dist) const;
 	Pose2dWithRotation operator[](int index) const;
 	int size() const {
 		return points_.size();
 	}
 
+private:
+	void findCurvatures();
+
 private:
 	QVector<double> distances_;
+	QVector<double> curvatures_;
 	QVector<Pose2dWithRotation> points_;
 };
 
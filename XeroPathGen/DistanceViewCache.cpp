@@ -0,0 +1,39 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "DistanceViewCache.h"
+#include <QtCore/QDataStream>
+
+DistanceViewCache::DistanceViewCache(int maxentries) : entries_(maxentries)
+{
+}
+
+QByteArray DistanceViewCache::computeKey(qint64 revision, double maxdx, double maxdy, double maxdtheta, double step, bool arclength)
+{
+	QByteArray data;
+	QDataStream strm(&data, QIODevice::WriteOnly);
+
+	strm.setByteOrder(QDataStream::LittleEndian);
+	strm.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+	strm << revision;
+	strm << maxdx;
+	strm << maxdy;
+	strm << maxdtheta;
+	strm << step;
+	strm << arclength;
+
+	return data;
+}
@@ -0,0 +1,61 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include "DistanceView.h"
+#include "LruCache.h"
+#include <QtCore/QByteArray>
+#include <memory>
+
+//
+// An in memory cache of the distance view for the whole of a path.  The key is the
+// geometry revision of the path and the resolution used to generate the points, so
+// a change that only affects the timing of a path, like the maximum velocity or a
+// constraint, goes straight to time parameterization.  The cache is shared by all
+// of the generator threads.
+//
+class DistanceViewCache
+{
+public:
+	DistanceViewCache(int maxentries = DefaultMaxEntries);
+
+	static QByteArray computeKey(qint64 revision, double maxdx, double maxdy, double maxdtheta, double step, bool arclength);
+
+	//
+	// Returns the view, or nullptr if the key is not in the cache
+	//
+	std::shared_ptr<const DistanceView> find(const QByteArray& key) {
+		return entries_.find(key);
+	}
+
+	void insert(const QByteArray& key, std::shared_ptr<const DistanceView> view) {
+		entries_.insert(key, view);
+	}
+
+	void clear() {
+		entries_.clear();
+	}
+
+	int size() {
+		return entries_.size();
+	}
+
+private:
+	static constexpr int DefaultMaxEntries = 64;
+
+private:
+	LruCache<QByteArray, std::shared_ptr<const DistanceView>> entries_;
+};
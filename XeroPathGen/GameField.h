@@ -30,7 +30,7 @@ public:
 		path_ = path;
 		name_ = name;
 		image_ = image;
-		units_ = units;
+		unit_ = UnitConverter::toUnit(units);
 		top_left_ = topleft;
 		bottom_right_ = bottomright;
 		size_ = size;
@@ -60,15 +60,16 @@ public:
 		return size_;
 	}
 
-	void convert(const QString& units) {
-		if (units != units_)
+	void convert(UnitConverter::Unit unit) {
+		if (unit != unit_)
 		{
-			double x = UnitConverter::convert(size_.getX(), units_, units);
-			double y = UnitConverter::convert(size_.getY(), units_, units);
+			double factor = UnitConverter::factor(unit_, unit);
+			double x = size_.getX() * factor;
+			double y = size_.getY() * factor;
 
 			size_ = Translation2d(x, y);
 
-			units_ = units;
+			unit_ = unit;
 		}
 	}
 
@@ -78,7 +79,7 @@ public:
 private:
 	QString name_;
 	QString image_;
-	QString units_;
+	UnitConverter::Unit unit_;
 	Translation2d top_left_;
 	Translation2d bottom_right_;
 	Translation2d size_;
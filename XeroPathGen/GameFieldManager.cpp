@@ -34,10 +34,10 @@ bool GameFieldManager::hasFile(QString filename)
 	return QFile::exists(path);
 }
 
-void GameFieldManager::convert(const QString &units)
+void GameFieldManager::convert(UnitConverter::Unit unit)
 {
 	for (auto field : fields_)
-		field->convert(units);
+		field->convert(unit);
 }
 
 bool GameFieldManager::exists(const QString& name)
@@ -15,6 +15,7 @@
 //
 #pragma once
 #include "ManagerBase.h"
+#include "UnitConverter.h"
 #include <QFile>
 #include <QDebug>
 #include <string>
@@ -39,7 +40,7 @@ public:
 	std::shared_ptr<GameField> getFieldByName(const QString& name);
 	std::shared_ptr<GameField> getDefaultField();
 
-	void convert(const QString &units);
+	void convert(UnitConverter::Unit unit);
 
 	static constexpr const char* gameTag = "game";
 	static constexpr const char* imageTag = "field-image";
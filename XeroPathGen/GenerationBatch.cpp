@@ -0,0 +1,76 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "GenerationBatch.h"
+
+GenerationBatch::GenerationBatch(const QVector<std::shared_ptr<RobotPath>>& paths)
+{
+	paths_ = paths;
+	remaining_ = paths;
+	canceled_ = false;
+}
+
+void GenerationBatch::complete(std::shared_ptr<RobotPath> path)
+{
+	if (canceled_ || !remaining_.removeOne(path)) {
+		return;
+	}
+
+	emit pathComplete(path);
+	emit progress(completed(), total());
+
+	if (isFinished()) {
+		emit finished();
+	}
+}
+
+void GenerationBatch::drop(std::shared_ptr<RobotPath> path)
+{
+	//
+	// The path was deleted, so it will never complete.  It still counts toward
+	// the progress of the batch.
+	//
+	if (canceled_ || !remaining_.removeOne(path)) {
+		return;
+	}
+
+	emit progress(completed(), total());
+
+	if (isFinished()) {
+		emit finished();
+	}
+}
+
+void GenerationBatch::finish()
+{
+	//
+	// Only a batch with nothing left to wait for can finish this way
+	//
+	if (canceled_ || !isFinished()) {
+		return;
+	}
+
+	emit finished();
+}
+
+void GenerationBatch::cancel()
+{
+	if (canceled_) {
+		return;
+	}
+
+	canceled_ = true;
+	emit canceled();
+}
@@ -0,0 +1,83 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include "RobotPath.h"
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+#include <memory>
+
+//
+// A handle for a set of paths requested from the GenerationMgr together.  It
+// reports each path as its full quality trajectories become available and
+// signals when every path in the batch is done.  If the manager is cleared
+// before the batch is done, the batch is canceled.  A batch with no paths
+// finishes as soon as the caller returns to the event loop.
+//
+class GenerationBatch : public QObject
+{
+	friend class GenerationMgr;
+
+	Q_OBJECT
+
+public:
+	GenerationBatch(const QVector<std::shared_ptr<RobotPath>>& paths);
+
+	const QVector<std::shared_ptr<RobotPath>>& paths() const {
+		return paths_;
+	}
+
+	int total() const {
+		return paths_.size();
+	}
+
+	int completed() const {
+		return paths_.size() - remaining_.size();
+	}
+
+	bool isFinished() const {
+		return remaining_.size() == 0;
+	}
+
+	bool isCanceled() const {
+		return canceled_;
+	}
+
+	bool contains(std::shared_ptr<RobotPath> path) const {
+		return remaining_.contains(path);
+	}
+
+	const QVector<std::shared_ptr<RobotPath>>& remaining() const {
+		return remaining_;
+	}
+
+signals:
+	void pathComplete(std::shared_ptr<RobotPath> path);
+	void progress(int completed, int total);
+	void finished();
+	void canceled();
+
+private:
+	void complete(std::shared_ptr<RobotPath> path);
+	void drop(std::shared_ptr<RobotPath> path);
+	void finish();
+	void cancel();
+
+private:
+	QVector<std::shared_ptr<RobotPath>> paths_;
+	QVector<std::shared_ptr<RobotPath>> remaining_;
+	bool canceled_;
+};
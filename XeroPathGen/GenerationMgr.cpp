@@ -19,13 +19,19 @@
 #include "PathGroup.h"
 #include <QtCore/QStandardPaths>
 #include <QtCore/QFile>
+#include <algorithm>
 
 GenerationMgr::GenerationMgr()
 {
-	worker_ = nullptr;
-	thread_ = nullptr;
-	active_type_ = GeneratorType::CheesyPoofs;
 	timestep_ = 0.02;
+	arc_length_ = false;
+	epoch_ = 0;
+	debounce_ = DefaultDebounceInterval;
+	lazy_ = false;
+
+	clock_.start();
+	debounce_timer_.setSingleShot(true);
+	connect(&debounce_timer_, &QTimer::timeout, this, &GenerationMgr::schedulePath);
 
 	QStringList dirs = QStandardPaths::standardLocations(QStandardPaths::AppLocalDataLocation);
 	logfile_ = dirs.front() + "/generators_log.txt";
@@ -34,6 +40,54 @@ GenerationMgr::GenerationMgr()
 	if (file.exists()) {
 		file.remove();
 	}
+
+	cache_.enableDiskCache(dirs.front() + "/trajcache");
+
+	createWorkers();
+}
+
+GenerationMgr::~GenerationMgr()
+{
+	//
+	// Nobody is left to care about outstanding batches, so drop them without signaling
+	//
+	batches_.clear();
+	clear();
+
+	for (Worker& w : workers_) {
+		w.thread->quit();
+	}
+
+	for (Worker& w : workers_) {
+		w.thread->wait();
+		delete w.thread;
+	}
+
+	workers_.clear();
+}
+
+void GenerationMgr::createWorkers()
+{
+	int count = std::max(1, QThread::idealThreadCount());
+
+	for (int i = 0; i < count; i++) {
+		Worker w;
+
+		w.thread = new QThread();
+		w.thread->setObjectName("generator " + QString::number(i + 1));
+		w.generator = new Generator(logfile_, loglock_);
+		w.generator->setSegmentCache(&segments_);
+		w.generator->setDistanceViewCache(&views_);
+		w.generator->setTrajectoryCache(&cache_);
+		w.generator->moveToThread(w.thread);
+		w.epoch = 0;
+
+		connect(w.thread, &QThread::finished, w.generator, &QObject::deleteLater);
+		connect(w.generator, &Generator::trajectoryComplete, this, &GenerationMgr::pathFinished);
+
+		w.thread->start();
+		workers_.push_back(w);
+	}
 }
 
 void GenerationMgr::clear()
@@ -42,11 +96,70 @@ void GenerationMgr::clear()
 	pending_queue_.clear();
 	pending_queue_mutex_.unlock();
 
-	if (thread_ != nullptr) {
-		thread_->terminate();
-		thread_ = nullptr;
-		worker_ = nullptr;
+	requests_.clear();
+
+	//
+	// Ask any generation in progress to stop at its next cancellation check.  Bumping the
+	// epoch means anything that still completes is discarded.
+	//
+	active_queue_mutex_.lock();
+	epoch_++;
+	for (Worker& w : workers_) {
+		if (w.group != nullptr) {
+			w.group->cancelToken().cancel();
+		}
+	}
+	active_queue_mutex_.unlock();
+
+	//
+	// None of the outstanding batches can complete now
+	//
+	QList<std::shared_ptr<GenerationBatch>> batches = batches_;
+	batches_.clear();
+	for (auto batch : batches) {
+		batch->cancel();
+	}
+}
+
+int GenerationMgr::activeCount() const
+{
+	int count = 0;
+
+	for (const Worker& w : workers_) {
+		if (w.group != nullptr) {
+			count++;
+		}
 	}
+
+	return count;
+}
+
+bool GenerationMgr::cancelActive(std::shared_ptr<RobotPath> path, const QByteArray& key, bool preview)
+{
+	bool running = false;
+
+	active_queue_mutex_.lock();
+	for (Worker& w : workers_) {
+		if (w.group == nullptr || w.group->path() != path || w.group->isCanceled()) {
+			continue;
+		}
+
+		if (w.epoch == epoch_ && w.key == key && (w.group->isPreview() == preview || !w.group->isPreview())) {
+			//
+			// The same inputs are already being generated, at least as well as asked for
+			//
+			running = true;
+		}
+		else if (w.key != key) {
+			//
+			// The results could never be shown, as they are not for the newest inputs
+			//
+			w.group->cancelToken().cancel();
+		}
+	}
+	active_queue_mutex_.unlock();
+
+	return running;
 }
 
 std::shared_ptr<TrajectoryGroup> GenerationMgr::getTrajectoryGroup(std::shared_ptr<RobotPath> path)
@@ -62,23 +175,145 @@ std::shared_ptr<TrajectoryGroup> GenerationMgr::getTrajectoryGroup(std::shared_p
 	return ret;
 }
 
-void GenerationMgr::addPath(GeneratorType type, std::shared_ptr<RobotPath> path)
+void GenerationMgr::addPath(GeneratorType type, std::shared_ptr<RobotPath> path, bool preview)
 {
 	if (robot_ != nullptr) {
-		removePath(path);
+		removePending(path);
+
+		QByteArray key = TrajectoryCache::computeKey(type, path, robot_, timestep_, arc_length_);
+
+		Request& request = requests_[path];
+		if (request.key != key) {
+			request.key = key;
+			request.full = false;
+		}
+
+		//
+		// Anything still being generated for this path with different inputs is out of
+		// date, so stop it.  If the same inputs are already being generated, the request
+		// is folded into the one in progress.
+		//
+		if (cancelActive(path, key, preview)) {
+			return;
+		}
+
+		auto group = cache_.find(key, type, path);
+		if (group != nullptr) {
+			//
+			// We have already generated a path with these exact inputs, so use the cached
+			// trajectories.  This is true for a preview as well, as the cached trajectories
+			// are full quality.  The completion signal is still delivered from the event loop
+			// so callers see the same behavior as a generated path.  Trajectories that are
+			// only on disk are read by a worker, so the GUI thread never waits on the disk.
+			//
+			trajectory_group_mutex_.lock();
+			trajectories_.insert(path, group);
+			trajectory_group_mutex_.unlock();
+			request.full = true;
+
+			QMetaObject::invokeMethod(this, [this, path]() { notifyComplete(path, false); }, Qt::QueuedConnection);
+			return;
+		}
+
+		PendingPath pending;
+		pending.type = type;
+		pending.path = path;
+		pending.preview = preview;
+		pending.demanded = false;
+		pending.ready = clock_.elapsed() + ((preview || cache_.isOnDisk(key)) ? 0 : debounce_);
+
 		pending_queue_mutex_.lock();
-		pending_queue_.push_back(QPair<GeneratorType, std::shared_ptr<RobotPath>>(type, path));
+		pending_queue_.push_back(pending);
 		pending_queue_mutex_.unlock();
 		schedulePath();
 	}
 }
 
+std::shared_ptr<GenerationBatch> GenerationMgr::addPaths(GeneratorType type, const QVector<std::shared_ptr<RobotPath>>& paths)
+{
+	auto batch = std::make_shared<GenerationBatch>(paths);
+
+	if (robot_ == nullptr) {
+		//
+		// Nothing can be generated, so the batch is canceled, but not until the caller
+		// has had a chance to connect to it
+		//
+		QMetaObject::invokeMethod(this, [batch]() { batch->cancel(); }, Qt::QueuedConnection);
+		return batch;
+	}
+
+	if (paths.size() == 0) {
+		//
+		// There is nothing to wait for, so the batch is already done.  It also signals once
+		// the caller has connected to it.
+		//
+		QMetaObject::invokeMethod(this, [batch]() { batch->finish(); }, Qt::QueuedConnection);
+		return batch;
+	}
+
+	batches_.push_back(batch);
+
+	for (auto path : paths) {
+		addPath(type, path);
+	}
+
+	pending_queue_mutex_.lock();
+	for (PendingPath& pending : pending_queue_) {
+		if (paths.contains(pending.path)) {
+			pending.demanded = true;
+		}
+	}
+	pending_queue_mutex_.unlock();
+
+	schedulePath();
+
+	return batch;
+}
+
 void GenerationMgr::removePath(std::shared_ptr<RobotPath> path)
+{
+	removePending(path);
+	requests_.remove(path);
+
+	//
+	// Stop any generation in progress for the path, and do not wait for it in any batch
+	//
+	cancelActive(path, QByteArray(), false);
+
+	QList<std::shared_ptr<GenerationBatch>> batches = batches_;
+	for (auto batch : batches) {
+		batch->drop(path);
+		if (batch->isFinished()) {
+			batches_.removeOne(batch);
+		}
+	}
+}
+
+void GenerationMgr::notifyComplete(std::shared_ptr<RobotPath> path, bool preview)
+{
+	emit generationComplete(path);
+
+	//
+	// A preview does not complete a path in a batch, the full quality trajectories
+	// are still to come
+	//
+	if (!preview) {
+		QList<std::shared_ptr<GenerationBatch>> batches = batches_;
+		for (auto batch : batches) {
+			batch->complete(path);
+			if (batch->isFinished()) {
+				batches_.removeOne(batch);
+			}
+		}
+	}
+}
+
+void GenerationMgr::removePending(std::shared_ptr<RobotPath> path)
 {
 	pending_queue_mutex_.lock();
 
 	auto it = std::find_if(pending_queue_.begin(), pending_queue_.end(), 
-		[&path](QPair<GeneratorType, std::shared_ptr<RobotPath>> pair) { return pair.second == path; });
+		[&path](const PendingPath& pending) { return pending.path == path; });
 
 	if (it != pending_queue_.end()) {
 		pending_queue_.erase(it);
@@ -87,47 +322,234 @@ void GenerationMgr::removePath(std::shared_ptr<RobotPath> path)
 	pending_queue_mutex_.unlock();
 }
 
+void GenerationMgr::setSelectedPath(std::shared_ptr<RobotPath> path)
+{
+	pending_queue_mutex_.lock();
+	selected_ = path;
+	pending_queue_mutex_.unlock();
+
+	schedulePath();
+}
+
+void GenerationMgr::setVisiblePaths(const QList<std::shared_ptr<RobotPath>>& paths)
+{
+	pending_queue_mutex_.lock();
+	visible_ = paths;
+	pending_queue_mutex_.unlock();
+
+	schedulePath();
+}
+
+void GenerationMgr::demandAll()
+{
+	pending_queue_mutex_.lock();
+	for (PendingPath& pending : pending_queue_) {
+		pending.demanded = true;
+	}
+	pending_queue_mutex_.unlock();
+
+	schedulePath();
+}
+
+GenerationMgr::Priority GenerationMgr::priority(std::shared_ptr<RobotPath> path, bool preview) const
+{
+	//
+	// A preview is only requested for a path being edited, which is treated the same
+	// as the selected path
+	//
+	if (preview || path == selected_) {
+		return Priority::Selected;
+	}
+
+	if (visible_.contains(path)) {
+		return Priority::Visible;
+	}
+
+	return Priority::Background;
+}
+
+int GenerationMgr::nextPending(qint64 now) const
+{
+	int best = -1;
+	Priority bestpri = Priority::Background;
+
+	for (int i = 0; i < pending_queue_.size(); i++) {
+		const PendingPath& pending = pending_queue_[i];
+
+		//
+		// Skip over paths that are still inside their debounce window
+		//
+		if (pending.ready > now) {
+			continue;
+		}
+
+		Priority pri = priority(pending.path, pending.preview);
+		if (pri == Priority::Background && lazy_ && !pending.demanded) {
+			continue;
+		}
+
+		//
+		// Within a priority paths are generated in the order they were requested
+		//
+		if (best == -1 || pri < bestpri) {
+			best = i;
+			bestpri = pri;
+		}
+	}
+
+	return best;
+}
+
+void GenerationMgr::startWorker(Worker& w, const PendingPath& pending)
+{
+	w.group = std::make_shared<TrajectoryGroup>(pending.type, pending.path, pending.preview);
+
+	//
+	// Carry forward what was learned generating this path last time so the search for
+	// the rotation velocity can start from there.  A preview does not search, so only
+	// a full quality group knows anything.
+	//
+	trajectory_group_mutex_.lock();
+	if (trajectories_.contains(pending.path)) {
+		auto last = trajectories_.value(pending.path);
+		if (!last->isPreview()) {
+			w.group->setRotationPercent(last->rotationPercent());
+		}
+	}
+	trajectory_group_mutex_.unlock();
+
+	//
+	// The path is only read here, on the GUI thread.  The worker is handed a copy of it,
+	// so the path can be edited while the worker runs, and the key always describes the
+	// inputs the results came from.
+	//
+	std::shared_ptr<RobotPath> snapshot = pending.path->snapshot();
+	w.key = TrajectoryCache::computeKey(pending.type, snapshot, robot_, timestep_, arc_length_);
+	w.epoch = epoch_;
+
+	Generator* gen = w.generator;
+	std::shared_ptr<TrajectoryGroup> group = w.group;
+	std::shared_ptr<RobotParams> robot = robot_;
+	double timestep = timestep_;
+	bool arclength = arc_length_;
+	QByteArray key = w.key;
+	QMetaObject::invokeMethod(gen, [gen, timestep, arclength, robot, group, snapshot, key]() { gen->generateTrajectory(timestep, arclength, robot, group, snapshot, key); }, Qt::QueuedConnection);
+}
+
 void GenerationMgr::schedulePath()
 {
+	qint64 now = clock_.elapsed();
+	qint64 next = -1;
+
 	pending_queue_mutex_.lock();
 	active_queue_mutex_.lock();
 
-	if (pending_queue_.size() > 0 && worker_ == nullptr && thread_ == nullptr) {
-		GeneratorType type = pending_queue_.front().first;
-		std::shared_ptr<RobotPath> path = pending_queue_.front().second;
+	for (Worker& w : workers_) {
+		if (w.group != nullptr) {
+			continue;
+		}
 
-		pending_queue_.pop_front();
-		pending_queue_mutex_.unlock();
+		int index = nextPending(now);
+		if (index == -1) {
+			break;
+		}
 
-		auto trajgrp = std::make_shared<TrajectoryGroup>(type, path);
+		startWorker(w, pending_queue_.takeAt(index));
+	}
 
-		thread_ = new QThread();
-		worker_ = new Generator(logfile_, loglock_, timestep_, robot_, trajgrp);
-		worker_->moveToThread(thread_);
+	//
+	// If the selected path is still waiting because every worker is busy, stop one that
+	// is working on a background path and put that path back in the queue.  If a worker
+	// is already stopping, it will pick up the selected path when it is done.
+	//
+	int index = nextPending(now);
+	if (index != -1 && priority(pending_queue_[index].path, pending_queue_[index].preview) == Priority::Selected) {
+		bool stopping = std::any_of(workers_.begin(), workers_.end(), [](const Worker& w) { return w.group != nullptr && w.group->isCanceled(); });
 
-		connect(thread_, &QThread::started, worker_, &Generator::generateTrajectory);
-		connect(thread_, &QThread::finished, worker_, &QObject::deleteLater);
+		for (int i = 0; i < workers_.size() && !stopping; i++) {
+			Worker& w = workers_[i];
+			if (w.group != nullptr && w.epoch == epoch_ && !w.group->isPreview() && priority(w.group->path(), false) == Priority::Background) {
+				w.group->cancelToken().cancel();
 
-		connect(worker_, &Generator::trajectoryComplete, this, &GenerationMgr::pathFinished);
-		connect(worker_, &Generator::trajectoryComplete, thread_, &QThread::quit);
-		connect(worker_, &Generator::trajectoryComplete, worker_, &QObject::deleteLater);
+				PendingPath pending;
+				pending.type = w.group->type();
+				pending.path = w.group->path();
+				pending.preview = false;
+				pending.demanded = true;
+				pending.ready = now;
+				pending_queue_.push_back(pending);
 
-		thread_->start();
+				stopping = true;
+			}
+		}
 	}
-	else {
-		pending_queue_mutex_.unlock();
+
+	//
+	// If any path is waiting on its debounce window, come back when the first window ends.
+	// Paths that are ready but have no free worker are picked up when a worker finishes.
+	//
+	for (const PendingPath& pending : pending_queue_) {
+		if (pending.ready > now && (next == -1 || pending.ready < next)) {
+			next = pending.ready;
+		}
 	}
+
 	active_queue_mutex_.unlock();
+	pending_queue_mutex_.unlock();
+
+	if (next != -1) {
+		debounce_timer_.start(static_cast<int>(next - now));
+	}
 }
 
 void GenerationMgr::pathFinished(std::shared_ptr<TrajectoryGroup> group)
 {
+	bool current = false;
+	QByteArray key;
+
 	active_queue_mutex_.lock();
-	thread_ = nullptr;
-	worker_ = nullptr;
-	trajectories_.insert(group->path(), group);
+	for (Worker& w : workers_) {
+		if (w.group == group) {
+			current = (w.epoch == epoch_ && !group->isCanceled());
+			key = w.key;
+			w.group = nullptr;
+			w.key.clear();
+			break;
+		}
+	}
 	active_queue_mutex_.unlock();
+
+	//
+	// The generator worked from a snapshot of the path, so the key describes the inputs
+	// that produced the results even if the path has been edited since
+	//
+	if (!group->isCanceled() && !group->isPreview() && key.size() > 0) {
+		cache_.insert(key, group);
+	}
+
+	//
+	// Results for anything but the newest request for the path are never shown, and a
+	// preview never replaces the full quality trajectories for the same inputs
+	//
+	if (current) {
+		auto it = requests_.find(group->path());
+		if (it == requests_.end() || it->key != key || (group->isPreview() && it->full)) {
+			current = false;
+		}
+		else if (!group->isPreview()) {
+			it->full = true;
+		}
+	}
+
+	if (current) {
+		trajectory_group_mutex_.lock();
+		trajectories_.insert(group->path(), group);
+		trajectory_group_mutex_.unlock();
+	}
+
 	schedulePath();
 
-	emit generationComplete(group->path());
-}
\ No newline at end of file
+	if (current) {
+		notifyComplete(group->path(), group->isPreview());
+	}
+}
@@ -20,9 +20,15 @@
 #include "Generator.h"
 #include "TrajectoryGroup.h"
 #include "RobotParams.h"
+#include "TrajectoryCache.h"
+#include "SegmentCache.h"
+#include "DistanceViewCache.h"
+#include "GenerationBatch.h"
 #include <QtCore/QObject>
 #include <QtCore/QMutex>
 #include <QtCore/QThread>
+#include <QtCore/QTimer>
+#include <QtCore/QElapsedTimer>
 
 class GenerationMgr : public QObject
 {
@@ -30,6 +36,7 @@ class GenerationMgr : public QObject
 
 public:
 	GenerationMgr();
+	virtual ~GenerationMgr();
 
 	void setTimestep(double t) {
 		timestep_ = t;
@@ -39,23 +46,86 @@ public:
 		return timestep_;
 	}
 
+	//
+	// Sample the splines directly at equal arc length, rather than subdividing them and
+	// resampling the points by distance.  This is part of the trajectory cache key, so
+	// paths requested after a change are generated again.
+	//
+	void setArcLengthSampling(bool b) {
+		arc_length_ = b;
+	}
+
+	bool isArcLengthSampling() const {
+		return arc_length_;
+	}
+
 	void setRobot(std::shared_ptr<RobotParams> robot) {
 		robot_ = robot;
 	}
 
-	void addPath(GeneratorType type, std::shared_ptr<RobotPath> path);
+	//
+	// The time in milliseconds a path must go without being changed before it is
+	// generated.  A path added again within this window replaces the earlier
+	// request and restarts the window.
+	//
+	void setDebounceInterval(int ms) {
+		debounce_ = ms;
+	}
+
+	int debounceInterval() const {
+		return debounce_;
+	}
+
+	//
+	// Paths are generated in priority order: the selected path first, then the
+	// visible paths, then everything else.  If lazy generation is enabled, paths
+	// that are neither selected nor visible are left in the queue until they are
+	// selected, made visible, or demanded with demandAll().
+	//
+	void setSelectedPath(std::shared_ptr<RobotPath> path);
+	void setVisiblePaths(const QList<std::shared_ptr<RobotPath>>& paths);
+
+	void setLazy(bool b) {
+		lazy_ = b;
+	}
+
+	bool isLazy() const {
+		return lazy_;
+	}
+
+	void demandAll();
+
+	//
+	// Request the trajectories for a path.  A preview request is generated right away
+	// at a coarse resolution, and is meant to be followed by a full request once the
+	// path stops changing.
+	//
+	void addPath(GeneratorType type, std::shared_ptr<RobotPath> path, bool preview = false);
 	void removePath(std::shared_ptr<RobotPath> path);
 
+	//
+	// Request the trajectories for a set of paths.  The returned batch signals as each
+	// path completes and when they are all complete.  Paths in a batch are always
+	// generated, even if lazy generation is enabled.
+	//
+	std::shared_ptr<GenerationBatch> addPaths(GeneratorType type, const QVector<std::shared_ptr<RobotPath>>& paths);
+
 	std::shared_ptr<TrajectoryGroup> getTrajectoryGroup(std::shared_ptr<RobotPath> path);
 
 	bool isEmpty() {
 		bool ret = true;
 		pending_queue_mutex_.lock();
-		ret = pending_queue_.size() == 0 && worker_ == nullptr;
+		active_queue_mutex_.lock();
+		ret = pending_queue_.size() == 0 && activeCount() == 0;
+		active_queue_mutex_.unlock();
 		pending_queue_mutex_.unlock();
 		return ret;
 	}
 
+	int workerCount() const {
+		return workers_.size();
+	}
+
 	void clear();
 
 	void removeAllTrajectories() {
@@ -64,29 +134,112 @@ public:
 		trajectory_group_mutex_.unlock();
 	}
 
+	TrajectoryCache& cache() {
+		return cache_;
+	}
+
 signals:
 	void generationComplete(std::shared_ptr<RobotPath> path);
 
 private:
+	static constexpr int DefaultDebounceInterval = 50;
+
+	enum class Priority
+	{
+		Selected,
+		Visible,
+		Background,
+	};
+
+	//
+	// A path waiting to be handed to a worker.  There is at most one of these
+	// per path, a newer request for a path replaces the older one.
+	//
+	struct PendingPath
+	{
+		GeneratorType type;
+		std::shared_ptr<RobotPath> path;
+		bool preview;
+		bool demanded;									// If true, generate even if lazy and not visible
+		qint64 ready;									// The time (from clock_) when the debounce window ends
+	};
+
+	//
+	// The newest request for a path.  Only results for these inputs are shown, and a
+	// preview is not shown once the full quality trajectories for them are.
+	//
+	struct Request
+	{
+		QByteArray key;									// The cache key for the inputs of the newest request
+		bool full;										// If true, the full quality trajectories for the key are shown
+	};
+
+	//
+	// One entry per worker thread in the pool.  The generator object lives on
+	// the thread and is reused for every path the worker is handed.
+	//
+	struct Worker
+	{
+		QThread* thread;
+		Generator* generator;
+		std::shared_ptr<TrajectoryGroup> group;			// The group being generated, nullptr if the worker is idle
+		QByteArray key;									// The cache key for the inputs of the group being generated
+		int epoch;										// The value of epoch_ when the group was handed to the worker
+	};
+
+private:
+	void createWorkers();
 	void schedulePath();
+	void startWorker(Worker& w, const PendingPath& pending);
+	Priority priority(std::shared_ptr<RobotPath> path, bool preview) const;
+	int nextPending(qint64 now) const;
 	void pathFinished(std::shared_ptr<TrajectoryGroup> path);
+	void notifyComplete(std::shared_ptr<RobotPath> path, bool preview);
+	void removePending(std::shared_ptr<RobotPath> path);
+	int activeCount() const;
+	bool cancelActive(std::shared_ptr<RobotPath> path, const QByteArray& key, bool preview);
 
 private:
 	QMutex pending_queue_mutex_;
-	QList<QPair<GeneratorType, std::shared_ptr<RobotPath>>> pending_queue_;
+	QList<PendingPath> pending_queue_;
+
+	QElapsedTimer clock_;
+	QTimer debounce_timer_;
+	int debounce_;
+
+	std::shared_ptr<RobotPath> selected_;
+	QList<std::shared_ptr<RobotPath>> visible_;
+	bool lazy_;
+
+	// Batches that still have paths outstanding
+	QList<std::shared_ptr<GenerationBatch>> batches_;
 
 	QMutex trajectory_group_mutex_;
 	QMap<std::shared_ptr<RobotPath>, std::shared_ptr<TrajectoryGroup>> trajectories_;
 
+	// The newest request for each path, only used on the GUI thread
+	QMap<std::shared_ptr<RobotPath>, Request> requests_;
+
+	TrajectoryCache cache_;
+
+	// The points for each spline segment, so a local edit only regenerates the segments it touches
+	SegmentCache segments_;
+
+	// The points for each path geometry, so a change to only the timing of a path skips straight to time parameterization
+	DistanceViewCache views_;
+
 	QMutex active_queue_mutex_;
-	GeneratorType active_type_;
-	std::shared_ptr<RobotPath> active_path_;
+	QVector<Worker> workers_;
 
-	Generator* worker_;
-	QThread *thread_;
+	//
+	// Incremented by clear().  Any group that completes with an older epoch was
+	// requested before the clear and its results are thrown away.
+	//
+	int epoch_;
 
 	std::shared_ptr<RobotParams> robot_;
 	double timestep_;
+	bool arc_length_;
 
 	QString logfile_;
 	QMutex loglock_;
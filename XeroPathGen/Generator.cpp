@@ -21,66 +21,132 @@
 #include "TrajectoryUtils.h"
 #include <QtCore/QThread>
 
-int Generator::global_which_ = 1;
+std::atomic<int> Generator::global_which_ = 1;
 
-Generator::Generator(const QString& logfile, QMutex& mutex, double timestep, std::shared_ptr<RobotParams> robot, std::shared_ptr<TrajectoryGroup> group)
+Generator::Generator(const QString& logfile, QMutex& mutex)
 	: logfile_(logfile), loglock_(mutex)
+{
+	timestep_ = 0.02;
+	which_ = 0;
+	segments_ = nullptr;
+	views_ = nullptr;
+	cache_ = nullptr;
+}
+
+void Generator::generateTrajectory(double timestep, bool arclength, std::shared_ptr<RobotParams> robot, std::shared_ptr<TrajectoryGroup> group,
+	std::shared_ptr<RobotPath> snapshot, const QByteArray& key)
 {
 	timestep_ = timestep;
 	group_ = group;
-	robot_ = robot ;
-
+	robot_ = robot;
 	which_ = global_which_++;
-}
 
-void Generator::generateTrajectory()
-{
-	auto path = group_->path();
-	std::shared_ptr<PathTrajectory> traj;
+	//
+	// If these exact inputs were generated in an earlier session, read the results back
+	// from disk rather than generating them again
+	//
+	if (cache_ != nullptr && !group_->isCanceled() && cache_->loadFromDisk(key, group_)) {
+		group_ = nullptr;
+		robot_ = nullptr;
 
-	double diststep = UnitConverter::convert(1.0, "in", path->units());			// 1 inch works well, convert to units being used
-	double maxdx = UnitConverter::convert(2.0, "in", path->units());			// 2 inches works well, convert to units being used
-	double maxdy = UnitConverter::convert(0.5, "in", path->units());			// 0.5 inches works well, convert to units being used
-	double maxtheta = 0.1;
+		emit trajectoryComplete(group);
+		return;
+	}
 
-	if (group_->type() == GeneratorType::CheesyPoofs) {
-		CheesyGenerator gen(logfile_, loglock_, which_, diststep, timestep_, maxdx, maxdy, maxtheta, robot_, false);
-		auto traj = gen.generate(path);
+	TrajectoryUtils::GeneratingThread generating;
 
-		if (traj != nullptr) {
-			group_->addTrajectory(traj);
-		}
+	auto path = snapshot;
+	std::shared_ptr<PathTrajectory> traj;
+
+	double diststep, maxdx, maxdy, maxtheta;
+
+	if (group_->isPreview()) {
+		//
+		// Coarse values, good enough to draw the path and its velocity while a
+		// waypoint is being dragged
+		//
+		diststep = UnitConverter::convert(4.0, UnitConverter::Unit::Inches, path->unit());
+		maxdx = UnitConverter::convert(8.0, UnitConverter::Unit::Inches, path->unit());
+		maxdy = UnitConverter::convert(2.0, UnitConverter::Unit::Inches, path->unit());
+		maxtheta = 0.3;
+	}
+	else {
+		diststep = UnitConverter::convert(1.0, UnitConverter::Unit::Inches, path->unit());		// 1 inch works well, convert to units being used
+		maxdx = UnitConverter::convert(2.0, UnitConverter::Unit::Inches, path->unit());			// 2 inches works well, convert to units being used
+		maxdy = UnitConverter::convert(0.5, UnitConverter::Unit::Inches, path->unit());			// 0.5 inches works well, convert to units being used
+		maxtheta = 0.1;
 	}
-	else if (group_->type() == GeneratorType::ErrorCodeXeroSwerve) {
-		CheesyGenerator gen(logfile_, loglock_, which_, diststep, timestep_, maxdx, maxdy, maxtheta, robot_, true);
-		auto traj = gen.generate(path);
 
-		if (traj != nullptr) {
-			group_->addTrajectory(traj);
+	try {
+		group_->cancelToken().throwIfCanceled();
+
+		if (group_->type() == GeneratorType::CheesyPoofs) {
+			CheesyGenerator gen(logfile_, loglock_, which_, diststep, timestep_, maxdx, maxdy, maxtheta, robot_, false);
+			gen.setCancelToken(&group_->cancelToken());
+			gen.setSegmentCache(segments_);
+			gen.setDistanceViewCache(views_);
+			gen.setArcLengthSampling(arclength);
+			gen.setPreview(group_->isPreview());
+			gen.setRotationHint(group_->rotationPercent());
+			auto traj = gen.generate(path);
+			if (gen.rotationPercent() >= 0.0) {
+				group_->setRotationPercent(gen.rotationPercent());
+			}
+
+			if (traj != nullptr) {
+				group_->addTrajectory(traj);
+			}
+		}
+		else if (group_->type() == GeneratorType::ErrorCodeXeroSwerve) {
+			CheesyGenerator gen(logfile_, loglock_, which_, diststep, timestep_, maxdx, maxdy, maxtheta, robot_, true);
+			gen.setCancelToken(&group_->cancelToken());
+			gen.setSegmentCache(segments_);
+			gen.setDistanceViewCache(views_);
+			gen.setArcLengthSampling(arclength);
+			gen.setPreview(group_->isPreview());
+			gen.setRotationHint(group_->rotationPercent());
+			auto traj = gen.generate(path);
+			if (gen.rotationPercent() >= 0.0) {
+				group_->setRotationPercent(gen.rotationPercent());
+			}
+
+			if (traj != nullptr) {
+				group_->addTrajectory(traj);
+			}
 		}
-	}
 
-	if (!group_->hasError()) {
-		if (robot_->getDriveType() == RobotParams::DriveType::TankDrive) {
-			//
-			// Add in trajectories for the left and right wheels.  These are here
-			// as they will always be independent of how the main trajectory is generated
-			//
-			addTankDriveTrajectories();
+		if (!group_->hasError()) {
+			if (robot_->getDriveType() == RobotParams::DriveType::TankDrive) {
+				//
+				// Add in trajectories for the left and right wheels.  These are here
+				// as they will always be independent of how the main trajectory is generated
+				//
+				addTankDriveTrajectories(robot_, path->unit(), group_);
+			}
 		}
 	}
+	catch (const GenerationCanceled&) {
+		//
+		// The results of this generation are no longer wanted.  The group is still
+		// returned so the manager knows this worker is free again.
+		//
+		group_->setErrorMessage("generation canceled");
+	}
+
+	group_ = nullptr;
+	robot_ = nullptr;
 
-	emit trajectoryComplete(group_);
+	emit trajectoryComplete(group);
 }
 
-void Generator::addTankDriveTrajectories()
+void Generator::addTankDriveTrajectories(std::shared_ptr<RobotParams> robot, UnitConverter::Unit unit, std::shared_ptr<TrajectoryGroup> group)
 {
 	//
 	// Get the width of the robot in the same units used by the paths
 	//
-	double width = UnitConverter::convert(robot_->getWheelBaseWidth(), robot_->getLengthUnits(), group_->path()->units());
+	double width = UnitConverter::convert(robot->getWheelBaseWidth(), robot->getLengthUnit(), unit);
 
-	auto traj = group_->getTrajectory(TrajectoryName::Main);
+	auto traj = group->getTrajectory(TrajectoryName::Main);
 	if (traj == nullptr) {
 		return;
 	}
@@ -156,12 +222,8 @@ void Generator::addTankDriveTrajectories()
 	assert(leftpts.size() == rightpts.size());
 
 	std::shared_ptr<PathTrajectory> left = std::make_shared<PathTrajectory>(TrajectoryName::Left, leftpts);
-	TrajectoryUtils::computeCurvature(left);
-
 	std::shared_ptr<PathTrajectory> right = std::make_shared<PathTrajectory>(TrajectoryName::Right, rightpts);
-	TrajectoryUtils::computeCurvature(right);
-
 
-	group_->addTrajectory(left);
-	group_->addTrajectory(right);
+	group->addTrajectory(left);
+	group->addTrajectory(right);
 }
\ No newline at end of file
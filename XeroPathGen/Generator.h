@@ -19,33 +19,73 @@
 #include "GeneratorType.h"
 #include "TrajectoryGroup.h"
 #include "RobotParams.h"
+#include "SegmentCache.h"
+#include "DistanceViewCache.h"
+#include "TrajectoryCache.h"
 #include <QtCore/QObject>
 #include <QtCore/QMutex>
 #include <memory>
+#include <atomic>
 
 class Generator : public QObject
 {
 	Q_OBJECT
 
 public:
-	Generator(const QString& logfile, QMutex& mutex, double timestep, std::shared_ptr<RobotParams> robot, std::shared_ptr<TrajectoryGroup> group);
+	Generator(const QString& logfile, QMutex& mutex);
 
-	void generateTrajectory();
+	//
+	// Generate the trajectories for a single group.  A generator lives on one of the
+	// GenerationMgr worker threads and is reused for many groups, one at a time.  The
+	// trajectories are generated from the path snapshot, never from the path held by the
+	// group, which may be edited while the generator runs.  The key is the trajectory
+	// cache key for the snapshot, and is used to look for the trajectories on disk
+	// before generating them.  With arclength set the splines are sampled at equal arc length.
+	//
+	void generateTrajectory(double timestep, bool arclength, std::shared_ptr<RobotParams> robot, std::shared_ptr<TrajectoryGroup> group,
+		std::shared_ptr<RobotPath> snapshot, const QByteArray& key);
+
+	//
+	// The cache of generated trajectories, only its disk cache is used here, may be nullptr
+	//
+	void setTrajectoryCache(TrajectoryCache* cache) {
+		cache_ = cache;
+	}
+
+	//
+	// The cache of spline segment points shared by all of the generators, may be nullptr
+	//
+	void setSegmentCache(SegmentCache* cache) {
+		segments_ = cache;
+	}
+
+	//
+	// The cache of whole path distance views shared by all of the generators, may be nullptr
+	//
+	void setDistanceViewCache(DistanceViewCache* cache) {
+		views_ = cache;
+	}
+
+	//
+	// Add the left and right wheel trajectories to a group holding the main trajectory
+	// for a tank drive robot
+	//
+	static void addTankDriveTrajectories(std::shared_ptr<RobotParams> robot, UnitConverter::Unit unit, std::shared_ptr<TrajectoryGroup> group);
 
 signals:
 	void trajectoryComplete(std::shared_ptr<TrajectoryGroup> group);
 
-private:
-	void addTankDriveTrajectories();
-
 private:
 	int which_;
 	double timestep_;
 	std::shared_ptr<TrajectoryGroup> group_;
 	std::shared_ptr<RobotParams> robot_;
+	SegmentCache* segments_;
+	DistanceViewCache* views_;
+	TrajectoryCache* cache_;
 
 	const QString& logfile_;
 	QMutex& loglock_;
 
-	static int global_which_;
+	static std::atomic<int> global_which_;
 };
\ No newline at end of file
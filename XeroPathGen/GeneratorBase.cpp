@@ -22,6 +22,8 @@
 #include <QtCore/QStandardPaths>
 #include <QtCore/QFile>
 #include <QtCore/QTextStream>
+#include <cmath>
+#include <limits>
 
 GeneratorBase::GeneratorBase(const QString &logfile, QMutex& loglock, int which, double diststep, double timestep, double maxdx, double maxdy, double maxtheta, std::shared_ptr<RobotParams> robot)
 	: logfile_(logfile), loglock_(loglock), which_(which)
@@ -32,6 +34,11 @@ GeneratorBase::GeneratorBase(const QString &logfile, QMutex& loglock, int which,
 	maxDx_ = maxdx;
 	maxDy_ = maxdy;
 	maxDTheta_ = maxtheta;
+	cancel_ = nullptr;
+	segments_ = nullptr;
+	views_ = nullptr;
+	arc_length_sampling_ = false;
+	dists_revision_ = -1;
 }
 
 void GeneratorBase::logMessage(const QString& msg)
@@ -51,32 +58,23 @@ void GeneratorBase::logMessage(const QString& msg)
 std::shared_ptr<PathTrajectory>
 GeneratorBase::generateInternal(std::shared_ptr<RobotPath> path, QVector<std::shared_ptr<PathConstraint>>& extras)
 {
-	double maxDxPath = UnitConverter::convert(maxDx_, robot()->getLengthUnits(), path->units());
-	double maxDyPath = UnitConverter::convert(maxDy_, robot()->getLengthUnits(), path->units());
-	double distSteppath = UnitConverter::convert(diststep_, robot()->getLengthUnits(), path->units());
+	double maxDxPath = UnitConverter::convert(maxDx_, robot()->getLengthUnit(), path->unit());
+	double maxDyPath = UnitConverter::convert(maxDy_, robot()->getLengthUnit(), path->unit());
+	double distSteppath = UnitConverter::convert(diststep_, robot()->getLengthUnit(), path->unit());
 
 	//
-	// Step 1: generate a set of splines that represent the path
-	//         (taken from the cheesy poofs code)
+	// Steps 1 - 3: generate a set of splines that represent the path, the points along
+	//              each spline where the curvature, x, and y do not differ by more than
+	//              maxDx_, maxDy_, maxDTheta_ (both taken from the cheesy poofs code), and
+	//              then points that are equi-distant apart (no more than diststep_)
 	//
-	QVector<std::shared_ptr<SplinePair>> splines = generateSplines(path->waypoints());
+	std::shared_ptr<const DistanceView> view = distanceView(path, maxDxPath, maxDyPath, distSteppath);
+	const DistanceView& distview = *view;
 
-	//
-	// Step 2: generate a set of points that represent the path where the curvature, x, and y do not 
-	//         differ to an amount greater than maxDx_, maxDy_, maxDTheta_
-	//         (taken from the cheesy poofs code)
-	//
-	QVector<Pose2dWithRotation> paramtraj = TrajectoryUtils::parameterize(splines, maxDxPath, maxDyPath, maxDTheta_);
-
-	//
-	// Step 3: generate a set of points that are equi-distant apart (diststep_).
-	//
-	DistanceView distview(paramtraj, distSteppath);
-
-	if (distview.size() == 1 && distview.length() < 1e-4) {
+	if (distview.length() < 1e-4) {
 		//
-		// We have a simple, two point path with the two points concurrent.  Just
-		// return a null trajectory, as this does not make any sense
+		// All of the waypoints are concurrent.  Just return a null trajectory, as this
+		// does not make any sense
 		//
 		return nullptr;
 	}
@@ -85,7 +83,8 @@ GeneratorBase::generateInternal(std::shared_ptr<RobotPath> path, QVector<std::sh
 	// Step 4: generate a timing view that meets the constraints of the system
 	//
 	const PathParameters& params = path->params();
-	QVector<std::shared_ptr<PathConstraint>> constraints;
+	QVector<std::shared_ptr<PathConstraint>>& constraints = constraints_;
+	constraints.clear();
 	constraints.append(path->constraints());
 	constraints.append(extras);
 	QVector<Pose2dWithTrajectory> pts = timeParameterize(distview, constraints, params.startVelocity(),
@@ -98,10 +97,10 @@ GeneratorBase::generateInternal(std::shared_ptr<RobotPath> path, QVector<std::sh
 
 
 	//
-	// Step 6: compute the curvature for the path
+	// Step 6: create the trajectory.  The curvature of each point was computed along
+	// with the distance view, so there is nothing left to compute.
 	//
 	auto traj = std::make_shared<PathTrajectory>(TrajectoryName::Main, uniform);
-	TrajectoryUtils::computeCurvature(traj);
 
 	//
 	// Return a trajectory
@@ -112,10 +111,11 @@ GeneratorBase::generateInternal(std::shared_ptr<RobotPath> path, QVector<std::sh
 
 void GeneratorBase::computeRobotParameters(std::shared_ptr<RobotPath> path)
 {
-	robot_width_ = UnitConverter::convert(robot_->getWheelBaseWidth(), robot_->getLengthUnits(), path->units());
-	robot_length_ = UnitConverter::convert(robot_->getWheelBaseLength(), robot_->getLengthUnits(), path->units());
-	robot_max_velocity_ = UnitConverter::convert(robot_->getMaxVelocity(), robot_->getLengthUnits(), path->units());
-	robot_max_accel_ = UnitConverter::convert(robot_->getMaxAccel(), robot_->getLengthUnits(), path->units());
+	double factor = UnitConverter::factor(robot_->getLengthUnit(), path->unit());
+	robot_width_ = robot_->getWheelBaseWidth() * factor;
+	robot_length_ = robot_->getWheelBaseLength() * factor;
+	robot_max_velocity_ = robot_->getMaxVelocity() * factor;
+	robot_max_accel_ = robot_->getMaxAccel() * factor;
 }
 
 QVector<std::shared_ptr<SplinePair>>
@@ -123,6 +123,7 @@ GeneratorBase::generateSplines(const QVector<Pose2dWithRotation>& points)
 {
 	QVector<std::shared_ptr<SplinePair>> splines;
 
+	splines.reserve(std::max(0, static_cast<int>(points.size()) - 1));
 	for (int i = 0; i < points.size() - 1; i++) {
 		const Pose2dWithRotation& p1 = points[i];
 		const Pose2dWithRotation& p2 = points[i + 1];
@@ -133,31 +134,242 @@ GeneratorBase::generateSplines(const QVector<Pose2dWithRotation>& points)
 	return splines;
 }
 
+const QVector<double>& GeneratorBase::waypointDistances(std::shared_ptr<RobotPath> path)
+{
+	if (dists_path_.lock() != path || dists_revision_ != path->geometryRevision()) {
+		dists_ = TrajectoryUtils::getDistancesForSplines(generateSplines(path->waypoints()));
+		dists_path_ = path;
+		dists_revision_ = path->geometryRevision();
+	}
+
+	return dists_;
+}
+
+QVector<Pose2dWithRotation>
+GeneratorBase::sampleSegments(std::shared_ptr<RobotPath> path, double maxdx, double maxdy, double step)
+{
+	static const double kEpsilon = 1e-6;
+	const QVector<Pose2dWithRotation>& waypoints = path->waypoints();
+	QVector<Pose2dWithRotation> results;
+
+	if (waypoints.size() < 2) {
+		return results;
+	}
+
+	QVector<QByteArray> keys(waypoints.size() - 1);
+	QVector<std::shared_ptr<const QVector<Pose2dWithRotation>>> segments(waypoints.size() - 1);
+	QVector<int> missing;
+	QVector<std::shared_ptr<SplinePair>> splines;
+
+	for (int i = 0; i < waypoints.size() - 1; i++) {
+		checkCanceled();
+
+		keys[i] = SegmentCache::computeKey(waypoints[i], waypoints[i + 1], maxdx, maxdy, maxDTheta_, step);
+		if (segments_ != nullptr) {
+			segments[i] = segments_->find(keys[i]);
+		}
+
+		if (segments[i] == nullptr) {
+			missing.push_back(i);
+			splines.push_back(std::make_shared<SplinePair>(waypoints[i], waypoints[i + 1]));
+		}
+	}
+
+	//
+	// The segments that are not in the cache do not depend on each other, so they are
+	// parameterized in parallel
+	//
+	if (!missing.isEmpty()) {
+		QVector<QVector<Pose2dWithRotation>> params = TrajectoryUtils::parameterizeEach(splines, maxdx, maxdy, maxDTheta_, cancel_);
+		for (int j = 0; j < missing.size(); j++) {
+			int i = missing[j];
+			segments[i] = std::make_shared<const QVector<Pose2dWithRotation>>(DistanceView::resample(params[j], step));
+
+			if (segments_ != nullptr) {
+				segments_->insert(keys[i], segments[i]);
+			}
+		}
+	}
+
+	int total = 0;
+	for (const std::shared_ptr<const QVector<Pose2dWithRotation>>& points : segments) {
+		total += points->size();
+	}
+	results.reserve(total);
+
+	for (int i = 0; i < waypoints.size() - 1; i++) {
+		const std::shared_ptr<const QVector<Pose2dWithRotation>>& points = segments[i];
+
+		//
+		// Each segment ends where the next one starts, so the end point is only kept for the
+		// last segment.  A segment between two concurrent waypoints adds nothing.
+		//
+		bool last = (i == waypoints.size() - 2);
+		if (!last && points->front().distance(points->back()) < kEpsilon) {
+			continue;
+		}
+
+		int count = last ? points->size() : points->size() - 1;
+		for (int j = 0; j < count; j++) {
+			results.push_back((*points)[j]);
+		}
+	}
+
+	return results;
+}
+
+DistanceView
+GeneratorBase::sampleArcLength(std::shared_ptr<RobotPath> path, double step)
+{
+	static const double kEpsilon = 1e-6;
+	const QVector<Pose2dWithRotation>& waypoints = path->waypoints();
+	QVector<Pose2dWithRotation> points;
+	QVector<double> distances;
+	double offset = 0.0;
+
+	if (waypoints.size() < 2) {
+		return DistanceView(points);
+	}
+
+	std::vector<double>& params = arc_params_;
+	SplineSamples& samples = arc_samples_;
+
+	for (int i = 0; i < waypoints.size() - 1; i++) {
+		checkCanceled();
+
+		SplinePair spline(waypoints[i], waypoints[i + 1]);
+		double length = spline.length();
+
+		//
+		// Each segment ends where the next one starts, so the end point is only kept for the
+		// last segment.  A segment between two concurrent waypoints adds nothing.
+		//
+		bool last = (i == waypoints.size() - 2);
+		if (!last && length < kEpsilon) {
+			continue;
+		}
+
+		spline.paramsByLength(step, params);
+		spline.evalBatch(params, samples);
+
+		int pieces = static_cast<int>(params.size()) - 1;
+		int count = last ? pieces + 1 : pieces;
+		for (int j = 0; j < count; j++) {
+			Pose2dWithRotation pt(Translation2d(samples.x[j], samples.y[j]), Rotation2d(samples.dx[j], samples.dy[j], true));
+
+			//
+			// A spline with no speed at a point, like a segment between concurrent waypoints,
+			// has no curvature there
+			//
+			double curvature = samples.curvature[j];
+			pt.setCurvature(std::isfinite(curvature) ? curvature : 0.0);
+
+			points.push_back(pt);
+			distances.push_back(offset + length * j / pieces);
+		}
+
+		offset += length;
+	}
+
+	return DistanceView(points, distances);
+}
+
+std::shared_ptr<const DistanceView>
+GeneratorBase::distanceView(std::shared_ptr<RobotPath> path, double maxdx, double maxdy, double step)
+{
+	qint64 revision = path->geometryRevision();
+	QByteArray key = DistanceViewCache::computeKey(revision, maxdx, maxdy, maxDTheta_, step, arc_length_sampling_);
+
+	if (views_ != nullptr) {
+		std::shared_ptr<const DistanceView> view = views_->find(key);
+		if (view != nullptr) {
+			return view;
+		}
+	}
+
+	std::shared_ptr<const DistanceView> view;
+	if (arc_length_sampling_) {
+		view = std::make_shared<const DistanceView>(sampleArcLength(path, step));
+	}
+	else {
+		view = std::make_shared<const DistanceView>(sampleSegments(path, maxdx, maxdy, step));
+	}
+
+	//
+	// If the waypoints were edited while the view was being generated, the view may not
+	// match the revision read above, so it is not cached
+	//
+	if (views_ != nullptr && path->geometryRevision() == revision) {
+		views_->insert(key, view);
+	}
+
+	return view;
+}
+
+QVector<double>
+GeneratorBase::velocityLimits(const DistanceView& view, const QVector<std::shared_ptr<PathConstraint>>& constraints, double maxvel)
+{
+	QVector<double> limits(view.size(), maxvel);
+
+	if (constraints.size() == 0) {
+		return limits;
+	}
+
+	//
+	// The positions are the distances held by the view, the same ones the forward pass uses
+	//
+	ConstraintPoints points;
+	points.view = &view;
+	points.positions = view.positions();
+	points.curvatures = view.curvatures();
+
+	for (auto constraint : constraints) {
+		checkCanceled();
+		constraint->applyMaxVelocity(points, limits, robot_);
+	}
+
+	return limits;
+}
+
 QVector<Pose2dWithTrajectory>
 GeneratorBase::timeParameterize(const DistanceView& view, const QVector<std::shared_ptr<PathConstraint>>& constraints,
 	double startvel, double endvel, double maxvel, double maxaccel)
 {
-	QVector<Pose2dConstrained> points;
+	QVector<Pose2dConstrained>& points = constrained_;
 	Pose2dConstrained predecessor;
 	const static double kEpsilon = 1e-6;
 
+	points.clear();
+	points.reserve(view.size());
+
 	predecessor.setPosition(0.0);
 	predecessor.setPose(view[static_cast<int>(0)]);
 	predecessor.setVelocity(startvel);
 	predecessor.setAccelMin(-maxaccel);
 	predecessor.setAccelMax(maxaccel);
 
+	//
+	// The constraints only depend on the position and curvature of a point, so the limit
+	// they place on the velocity at each point is found once, before the forward pass
+	//
+	QVector<double> limits = velocityLimits(view, constraints, maxvel);
+
 	//
 	// Forward pass
 	//
 	for (int i = 0; i < view.size(); i++)
 	{
+		checkCanceled();
+
 		Pose2dConstrained state;
 		state.setPose(view[i]);
 		state.setPosition(view.getPosition(i));
 
-		double dist = predecessor.pose().distance(state.pose());
-		state.setPosition(predecessor.position() + dist);
+		//
+		// The view holds the distance along the path to each point, which is the exact arc
+		// length when the splines are sampled by arc length
+		//
+		double dist = state.position() - predecessor.position();
 
 		while (true)
 		{
@@ -169,12 +381,7 @@ GeneratorBase::timeParameterize(const DistanceView& view, const QVector<std::sha
 
 			state.setAccelMin(-maxaccel);
 			state.setAccelMax(maxaccel);
-
-			for (auto constraint : constraints)
-			{
-				double convel = constraint->getMaxVelocity(state, robot_);
-				state.setVelocity(std::min(state.velocity(), convel));
-			}
+			state.setVelocity(std::min(state.velocity(), limits[i]));
 
 			if (state.velocity() < 0.0)
 				throw std::runtime_error("invalid maximum velocity - constraint set to negative");
@@ -217,6 +424,8 @@ GeneratorBase::timeParameterize(const DistanceView& view, const QVector<std::sha
 
 	for (int i = points.size() - 1; i >= 0 ; i--)
 	{
+		checkCanceled();
+
 		Pose2dConstrained state = points[i];
 		double dist = state.position() - sucessor.position();				// Will be negative
 
@@ -260,6 +469,8 @@ GeneratorBase::timeParameterize(const DistanceView& view, const QVector<std::sha
 	double v = 0.0;
 	QVector<Pose2dWithTrajectory> result;
 
+	result.reserve(points.size());
+
 	for (int i = 0; i < points.size(); i++)
 	{
 		const Pose2dConstrained& state = points[i];
@@ -292,53 +503,40 @@ GeneratorBase::timeParameterize(const DistanceView& view, const QVector<std::sha
 }
 
 
-int GeneratorBase::findIndex(const QVector<Pose2dWithTrajectory>& traj, double time)
+QVector<Pose2dWithTrajectory> GeneratorBase::convertToUniformTime(const QVector<Pose2dWithTrajectory>& traj, double step)
 {
-	if (time < traj[0].time())
-		return 0;
-
-	if (time > traj[traj.size() - 1].time())
-		return traj.size() - 1;
+	QVector<Pose2dWithTrajectory> result;
 
-	int low = 0;
-	int high = traj.size() - 1;
+	if (traj.size() < 2)
+		return result;
 
-	while (high - low > 1)
-	{
-		int center = (high + low) / 2;
-		if (time > traj[center].time())
-		{
-			low = center;
-		}
-		else
-		{
-			high = center;
-		}
-	}
+	//
+	// The sample times are i * step for every i where the time is before the end of the
+	// path.  Computing each time from its index, rather than adding up the steps, keeps
+	// round off from adding or dropping the last sample on a long path.
+	//
+	double endtime = traj[traj.size() - 1].time();
+	int count = static_cast<int>(std::ceil(endtime / step));
+	while (count > 0 && (count - 1) * step >= endtime)
+		count--;
 
-	return low;
-}
+	result.reserve(count);
 
-QVector<Pose2dWithTrajectory> GeneratorBase::convertToUniformTime(const QVector<Pose2dWithTrajectory>& traj, double step)
-{
-	QVector<Pose2dWithTrajectory> result;
-
-	for (double time = 0.0; time < traj[traj.size() - 1].time(); time += step)
+	//
+	// The sample times and the point times both increase, so a single cursor walks
+	// forward through the points as the samples are generated
+	//
+	int low = 0;
+	for (int i = 0; i < count; i++)
 	{
-		Pose2dWithTrajectory newpt;
+		double time = i * step;
 
-		int low = findIndex(traj, time);
-		if (low == traj.size() - 1)
-		{
-			newpt = traj[traj.size() - 1];
-		}
-		else
-		{
-			double percent = (time - traj[low].time()) / (traj[low + 1].time() - traj[low].time());
-			newpt = traj[low].interpolate(traj[low + 1], percent);
-		}
+		while (low < traj.size() - 2 && traj[low + 1].time() < time)
+			low++;
 
-		result.push_back(newpt);
+		double dt = traj[low + 1].time() - traj[low].time();
+		double percent = (dt > 0.0) ? (time - traj[low].time()) / dt : 0.0;
+		result.push_back(traj[low].interpolate(traj[low + 1], percent));
 	}
 
 	return result;
@@ -349,10 +547,12 @@ int GeneratorBase::findIndexFromLocation(std::shared_ptr<PathTrajectory> traj, i
 {
 	static double tol = 0.05;
 
+	const QVector<double>& xs = traj->xs();
+	const QVector<double>& ys = traj->ys();
+
 	for (int i = start; i < traj->size(); i++)
 	{
-		auto pt = (*traj)[i];
-		if (std::abs(pt.x() - loc.getX()) < tol && std::abs(pt.y() - loc.getY()) < tol)
+		if (std::abs(xs[i] - loc.getX()) < tol && std::abs(ys[i] - loc.getY()) < tol)
 		{
 			return i;
 		}
@@ -395,12 +595,13 @@ Translation2d GeneratorBase::getWheelPerpendicularVector(Wheel w, double magnitu
 
 bool GeneratorBase::modifyForRotation(std::shared_ptr<RobotPath> path, std::shared_ptr<PathTrajectory> traj, double percent)
 {
-	QVector<std::shared_ptr<SplinePair>> splines = generateSplines(path->waypoints());
-	QVector<double> dists = TrajectoryUtils::getDistancesForSplines(splines);
+	const QVector<double>& dists = waypointDistances(path);
 	assert(dists.size() == path->waypoints().size());
 
 	for (int i = 0; i < path->size() - 1; i++) 
 	{
+		checkCanceled();
+
 		double startTime, endTime;
 		int startIndex, endIndex;
 		double startRot = path->getPoint(i).getSwrot().toDegrees();
@@ -416,6 +617,8 @@ bool GeneratorBase::modifyForRotation(std::shared_ptr<RobotPath> path, std::shar
 			return false;
 		}
 		startIndex = traj->getIndex(startTime);
+		if (startIndex == -1)
+			return false;
 
 		if (!traj->getTimeForDistance(dists[i + 1], endTime))
 		{
@@ -426,6 +629,8 @@ bool GeneratorBase::modifyForRotation(std::shared_ptr<RobotPath> path, std::shar
 		}
 
 		endIndex = traj->getIndex(endTime);
+		if (endIndex == -1)
+			return false;
 
 		if (traj->size() - endIndex < 5) {
 			//
@@ -449,6 +654,30 @@ bool GeneratorBase::modifyForRotation(std::shared_ptr<RobotPath> path, std::shar
 	return true;
 }
 
+double GeneratorBase::rotationTime(std::shared_ptr<RobotPath> path, double percent, double startRot, double startRotVel, double endRot, double endRotVel)
+{
+	double diff = MathUtils::boundDegrees(endRot - startRot);
+	if (diff == 0.0 && startRotVel == 0.0 && endRotVel == 0.0) {
+		return 0.0;
+	}
+
+	double maxaccel = TrajectoryUtils::linearToRotational(robot_, path->params().maxAccel() * percent);
+	double maxvel = TrajectoryUtils::linearToRotational(robot_, path->params().maxVelocity() * percent);
+
+	TrapezoidalProfile tp(maxaccel, -maxaccel, maxvel);
+	try {
+		if (!tp.update(diff, startRotVel, endRotVel)) {
+			return std::numeric_limits<double>::infinity();
+		}
+	}
+	catch (const std::runtime_error&) {
+		return std::numeric_limits<double>::infinity();
+	}
+
+	double total = tp.getTotalTime();
+	return std::isfinite(total) ? total : std::numeric_limits<double>::infinity();
+}
+
 bool GeneratorBase::modifySegmentForRotation(std::shared_ptr<RobotPath> path, std::shared_ptr<PathTrajectory> traj, double percent, int start, int end, double startRot, double startRotVel, double endRot, double endRotVel)
 {
 	QString logmsg;
@@ -458,11 +687,6 @@ bool GeneratorBase::modifySegmentForRotation(std::shared_ptr<RobotPath> path, st
 	assert(end > start);
 
 	std::shared_ptr<TrapezoidalProfile> tp;
-	QVector<Pose2dWithTrajectory> flpts, frpts, blpts, brpts;
-	bool first = true;
-
-	Translation2d prevfl, prevfr, prevbl, prevbr;
-	double fldist = 0, frdist = 0, bldist = 0, brdist = 0;
 
 	//
 	// Get the time interval between the points
@@ -619,60 +843,8 @@ bool GeneratorBase::modifySegmentForRotation(std::shared_ptr<RobotPath> path, st
 			return false;
 		}
 
-		Rotation2d heading = pt.rotation();
-		Translation2d pathvel = Translation2d(heading, pt.velocity()).rotateBy(Rotation2d::fromDegrees(-angle.toDegrees()));
-		Translation2d pathacc = Translation2d(heading, pt.acceleration()).rotateBy(Rotation2d::fromDegrees(-angle.toDegrees()));
-
-		Translation2d flv = rotflvel + pathvel;
-		Translation2d frv = rotfrvel + pathvel;
-		Translation2d blv = rotblvel + pathvel;
-		Translation2d brv = rotbrvel + pathvel;
-
-		Translation2d fla = rotflacc + pathacc;
-		Translation2d fra = rotfracc + pathacc;
-		Translation2d bla = rotblacc + pathacc;
-		Translation2d bra = rotbracc + pathacc;
-
-		Translation2d flpos = Translation2d(robot_length_ / 2.0, robot_width_ / 2.0).rotateBy(angle).translateBy(pt.translation());
-		Translation2d frpos = Translation2d(robot_length_ / 2.0, -robot_width_ / 2.0).rotateBy(angle).translateBy(pt.translation());
-		Translation2d blpos = Translation2d(-robot_length_ / 2.0, robot_width_ / 2.0).rotateBy(angle).translateBy(pt.translation());
-		Translation2d brpos = Translation2d(-robot_length_ / 2.0, -robot_width_ / 2.0).rotateBy(angle).translateBy(pt.translation());
-
-		if (!first)
-		{
-			fldist += flpos.distance(prevfl);
-			frdist += frpos.distance(prevfr);
-			bldist += blpos.distance(prevbl);
-			brdist += brpos.distance(prevbr);
-		}
-		else
-		{
-			first = false;
-		}
-
-		Pose2d flpose(flpos, flv.toRotation());
-		Pose2dWithTrajectory fltraj(flpose, time, fldist, flv.normalize(), fla.normalize());
-		flpts.push_back(fltraj);
-
-		Pose2d frpose(frpos, frv.toRotation());
-		Pose2dWithTrajectory frtraj(frpose, time, frdist, frv.normalize(), fra.normalize());
-		frpts.push_back(frtraj);
-
-		Pose2d blpose(blpos, blv.toRotation());
-		Pose2dWithTrajectory bltraj(blpose, time, bldist, blv.normalize(), bla.normalize());
-		blpts.push_back(bltraj);
-
-		Pose2d brpose(brpos, brv.toRotation());
-		Pose2dWithTrajectory brtraj(brpose, time, brdist, brv.normalize(), bra.normalize());
-		brpts.push_back(brtraj);
-
-		prevfl = flpos;
-		prevfr = frpos;
-		prevbl = blpos;
-		prevbr = brpos;
-
-		(*traj)[i].pose().setSwrot(angle);
-		(*traj)[i].setRotVel(rotvel);
+		traj->setSwrot(i, angle);
+		traj->setRotVel(i, rotvel);
 	}
 
 	return true;
@@ -18,10 +18,14 @@
 #include "SplinePair.h"
 #include "Pose2dWithRotation.h"
 #include "Pose2dWithTrajectory.h"
+#include "Pose2dConstrained.h"
 #include "PathConstraint.h"
 #include "DistanceView.h"
 #include "SwerveWheels.h"
 #include "PathTrajectory.h"
+#include "CancelToken.h"
+#include "SegmentCache.h"
+#include "DistanceViewCache.h"
 #include <QtCore/QVector>
 #include <QtCore/QMutex>
 #include <memory>
@@ -30,6 +34,13 @@ class RobotParams;
 
 class GeneratorBase
 {
+public:
+	//
+	// Increment this whenever a change to the generators changes the trajectories
+	// they produce, so that trajectories cached by an older version are not used
+	//
+	static constexpr int Version = 9;
+
 public:
 	GeneratorBase(const QString &logfile, QMutex& loglock, int which, double diststep, double timestep, double maxdx, double maxdy, double maxtheta, std::shared_ptr<RobotParams> robot);
 
@@ -37,6 +48,27 @@ public:
 		return robot_;
 	}
 
+	void setCancelToken(const CancelToken* token) {
+		cancel_ = token;
+	}
+
+	void setSegmentCache(SegmentCache* cache) {
+		segments_ = cache;
+	}
+
+	void setDistanceViewCache(DistanceViewCache* cache) {
+		views_ = cache;
+	}
+
+	//
+	// By default the splines are subdivided into points that are then resampled by the
+	// distance between them.  With arc length sampling each spline is sampled directly
+	// at equal arc length and the curvature comes from the spline itself.
+	//
+	void setArcLengthSampling(bool v) {
+		arc_length_sampling_ = v;
+	}
+
 protected:
 	double getMaxDx() const { return maxDx_; }
 	double getMaxDy() const { return maxDy_; }
@@ -49,11 +81,40 @@ protected:
 
 	QVector<std::shared_ptr<SplinePair>> generateSplines(const QVector<Pose2dWithRotation>& points);
 
+	//
+	// The distance along the path to each waypoint.  The splines are only built for the
+	// first pass over a path, and the distances are kept for the passes after it.
+	//
+	const QVector<double>& waypointDistances(std::shared_ptr<RobotPath> path);
+
+	//
+	// The points along the path, evenly spaced by distance within each segment between
+	// two waypoints.  Segments found in the segment cache are not generated again.
+	//
+	QVector<Pose2dWithRotation> sampleSegments(std::shared_ptr<RobotPath> path, double maxdx, double maxdy, double step);
+
+	//
+	// The distance view for the whole path.  A view found in the distance view cache for
+	// the current geometry of the path is not generated again.
+	//
+	std::shared_ptr<const DistanceView> distanceView(std::shared_ptr<RobotPath> path, double maxdx, double maxdy, double step);
+
+	//
+	// The distance view for the whole path, sampled directly from the splines at equal arc
+	// length within each segment between two waypoints
+	//
+	DistanceView sampleArcLength(std::shared_ptr<RobotPath> path, double step);
+
 	QVector<Pose2dWithTrajectory> timeParameterize(const DistanceView& view, const QVector<std::shared_ptr<PathConstraint>>& constraints,
 		double startvel, double endvel, double maxvel, double maxaccel);
 
+	//
+	// The lowest maximum velocity allowed by the constraints at each point of the view,
+	// and never more than maxvel
+	//
+	QVector<double> velocityLimits(const DistanceView& view, const QVector<std::shared_ptr<PathConstraint>>& constraints, double maxvel);
+
 	QVector<Pose2dWithTrajectory> convertToUniformTime(const QVector<Pose2dWithTrajectory>& traj, double step);
-	int findIndex(const QVector<Pose2dWithTrajectory>& traj, double time);
 
 
 	Translation2d getWheelPerpendicularVector(Wheel w, double magnitude);
@@ -78,8 +139,25 @@ protected:
 	bool modifySegmentForRotation(std::shared_ptr<RobotPath> path, std::shared_ptr<PathTrajectory> traj, double percent, int start, int end, double startRot, double startRotVel, double endRot, double endRotVel);
 	bool modifyForRotation(std::shared_ptr<RobotPath> path, std::shared_ptr<PathTrajectory> traj, double percent);
 
+	//
+	// The shortest time to rotate from startRot to endRot (degrees) when the given percent
+	// of the path velocity and acceleration is used for rotation.  Returns infinity if the
+	// rotation is not possible.
+	//
+	double rotationTime(std::shared_ptr<RobotPath> path, double percent, double startRot, double startRotVel, double endRot, double endRotVel);
+
 	void logMessage(const QString& msg);
 
+	const CancelToken* cancelToken() const {
+		return cancel_;
+	}
+
+	void checkCanceled() const {
+		if (cancel_ != nullptr) {
+			cancel_->throwIfCanceled();
+		}
+	}
+
 private:
 	std::shared_ptr<RobotParams> robot_;
 
@@ -97,5 +175,26 @@ private:
 	const QString &logfile_;
 	QMutex &loglock_;
 	int which_;
+
+	const CancelToken* cancel_;
+	SegmentCache* segments_;
+	DistanceViewCache* views_;
+	bool arc_length_sampling_;
+
+	//
+	// The distances from waypointDistances(), and the path and geometry they are for
+	//
+	std::weak_ptr<const RobotPath> dists_path_;
+	qint64 dists_revision_;
+	QVector<double> dists_;
+
+	//
+	// Scratch space that keeps its capacity from one pass to the next, so the passes of
+	// a swerve rotation search do not allocate it again
+	//
+	QVector<std::shared_ptr<PathConstraint>> constraints_;
+	QVector<Pose2dConstrained> constrained_;
+	std::vector<double> arc_params_;
+	SplineSamples arc_samples_;
 };
 
@@ -0,0 +1,102 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <list>
+#include <utility>
+
+//
+// A map from keys to values that holds at most a fixed number of entries.  When it
+// is full, inserting a new entry removes the entry that was used least recently.
+// Finding, inserting and evicting an entry each take constant time.  The cache
+// locks itself, so it can be shared by all of the generator threads.
+//
+template<class K, class V>
+class LruCache
+{
+public:
+	LruCache(int maxentries) {
+		max_entries_ = maxentries;
+	}
+
+	//
+	// Returns the value for the key and marks it as the most recently used, or a
+	// default constructed value if the key is not in the cache
+	//
+	V find(const K& key) {
+		V ret = V();
+
+		mutex_.lock();
+		auto it = index_.constFind(key);
+		if (it != index_.constEnd()) {
+			order_.splice(order_.end(), order_, it.value());
+			ret = it.value()->second;
+		}
+		mutex_.unlock();
+
+		return ret;
+	}
+
+	void insert(const K& key, const V& value) {
+		mutex_.lock();
+
+		auto it = index_.constFind(key);
+		if (it != index_.constEnd()) {
+			it.value()->second = value;
+			order_.splice(order_.end(), order_, it.value());
+		}
+		else {
+			order_.emplace_back(key, value);
+			index_.insert(key, std::prev(order_.end()));
+
+			while (index_.size() > max_entries_) {
+				index_.remove(order_.front().first);
+				order_.pop_front();
+			}
+		}
+
+		mutex_.unlock();
+	}
+
+	void clear() {
+		mutex_.lock();
+		index_.clear();
+		order_.clear();
+		mutex_.unlock();
+	}
+
+	int size() {
+		mutex_.lock();
+		int ret = index_.size();
+		mutex_.unlock();
+		return ret;
+	}
+
+private:
+	typedef std::list<std::pair<K, V>> List;
+
+private:
+	QMutex mutex_;
+	int max_entries_;
+
+	// Entries from least recently used to most recently used
+	List order_;
+
+	// Where each key is in the list
+	QHash<K, typename List::iterator> index_;
+};
@@ -21,6 +21,7 @@
 #include <QFile>
 #include <QVersionNumber>
 #include <cassert>
+#include <list>
 
 class ManagerBase
 {
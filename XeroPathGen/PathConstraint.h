@@ -17,12 +17,41 @@
 
 #include "MinMaxAcceleration.h"
 #include "Pose2dWithTrajectory.h"
+#include "DistanceView.h"
 #include "RobotParams.h"
+#include "UnitConverter.h"
 #include <QtCore/QJsonObject>
+#include <QtCore/QVector>
+#include <algorithm>
 #include <memory>
 
 class RobotPath;
 
+//
+// The points of a path that the constraints are applied to.  The position and
+// curvature of each point are held in their own arrays so a constraint can work
+// through them in a tight loop.  The arrays are shared with the distance view, so
+// nothing is copied for each pass.  The full state of a point is only built if a
+// constraint asks for it.
+//
+struct ConstraintPoints
+{
+	const DistanceView* view;
+	QVector<double> positions;
+	QVector<double> curvatures;
+
+	int size() const {
+		return positions.size();
+	}
+
+	Pose2dWithTrajectory state(int index) const {
+		Pose2dWithTrajectory ret;
+		ret.setPose((*view)[index]);
+		ret.setPosition(positions[index]);
+		return ret;
+	}
+};
+
 class PathConstraint
 {
 public:
@@ -34,8 +63,19 @@ public:
 	}
 
 	virtual double getMaxVelocity(const Pose2dWithTrajectory& state, std::shared_ptr<RobotParams> robot) = 0;
+	//
+	// Lower each entry in limits to the maximum velocity this constraint allows at the
+	// matching point.  The default calls getMaxVelocity() for each point, a constraint
+	// overrides this when the work can be done once for all of the points.
+	//
+	virtual void applyMaxVelocity(const ConstraintPoints& points, QVector<double>& limits, std::shared_ptr<RobotParams> robot) {
+		for (int i = 0; i < points.size(); i++) {
+			limits[i] = std::min(limits[i], getMaxVelocity(points.state(i), robot));
+		}
+	}
+
 	virtual MinMaxAcceleration getMinMaxAccel(const Pose2dWithTrajectory& state, double velocity, std::shared_ptr<RobotParams> robot) = 0;
-	virtual void convert(const QString& from, const QString &to) = 0;
+	virtual void convert(UnitConverter::Unit from, UnitConverter::Unit to) = 0;
 	virtual QJsonObject toJSON() const = 0;
 	virtual QString toString() const = 0;
 	virtual std::shared_ptr<PathConstraint> clone(const std::shared_ptr<RobotPath> path) = 0;
@@ -33,7 +33,7 @@ PathFieldView::PathFieldView(PathsDataModel&model, QWidget *parent) : QWidget(pa
 {
 	QImage* im;
 
-	units_ = "in";
+	unit_ = UnitConverter::Unit::Inches;
 	setMouseTracking(true);
 	setFocusPolicy(Qt::ClickFocus);
 	selected_ = std::numeric_limits<int>::max();
@@ -50,24 +50,26 @@ PathFieldView::~PathFieldView()
 
 void PathFieldView::setUnits(const QString& units)
 {
+	UnitConverter::Unit unit = UnitConverter::toUnit(units);
+
 	for (int i = 0; i < triangle_.size(); i++)
 	{
-		double x = UnitConverter::convert(triangle_[i].rx(), units_, units);
-		double y = UnitConverter::convert(triangle_[i].ry(), units_, units);
+		double x = UnitConverter::convert(triangle_[i].rx(), unit_, unit);
+		double y = UnitConverter::convert(triangle_[i].ry(), unit_, unit);
 		triangle_[i] = QPointF(x, y);
 	}
 
 	for (int i = 0; i < arrow_.size(); i++)
 	{
-		double x = UnitConverter::convert(arrow_[i].rx(), units_, units);
-		double y = UnitConverter::convert(arrow_[i].ry(), units_, units);
+		double x = UnitConverter::convert(arrow_[i].rx(), unit_, unit);
+		double y = UnitConverter::convert(arrow_[i].ry(), unit_, unit);
 		arrow_[i] = QPointF(x, y);
 	}
 
-	robot_width_ = UnitConverter::convert(robot_width_, units_, units);
-	robot_length_ = UnitConverter::convert(robot_length_, units_, units);
+	robot_width_ = UnitConverter::convert(robot_width_, unit_, unit);
+	robot_length_ = UnitConverter::convert(robot_length_, unit_, unit);
 
-	units_ = units;
+	unit_ = unit;
 	createTransforms();
 	repaint();
 }
@@ -334,7 +336,7 @@ void PathFieldView::moveWaypoint(bool shift, int dx, int dy)
 		emitWaypointStartMoving(selected_);
 
 		double delta = shift ? SmallWaypointMove : BigWaypointMove;
-		delta = UnitConverter::convert(delta, "in", units_);
+		delta = UnitConverter::convert(delta, UnitConverter::Unit::Inches, unit_);
 
 		const Pose2dWithRotation& pt = path_->getPoint(selected_);
 
@@ -520,8 +522,8 @@ QVector<QPointF> PathFieldView::transformPoints(QTransform& trans, const QVector
 
 void PathFieldView::drawWheel(QPainter& paint, QBrush &brush, const Translation2d& loc, const Pose2dWithRotation& pose)
 {
-	static const double wheelWidth = UnitConverter::convert(2.0, "in", units_);
-	static const double wheelLength = UnitConverter::convert(4.0, "in", units_);
+	double wheelWidth = UnitConverter::convert(2.0, UnitConverter::Unit::Inches, unit_);
+	double wheelLength = UnitConverter::convert(4.0, UnitConverter::Unit::Inches, unit_);
 
 	Translation2d fl, fr, bl, br;
 	fl = Translation2d(wheelWidth, wheelLength);
@@ -561,18 +563,17 @@ void PathFieldView::drawRobot(QPainter& paint)
 	if (path_ == nullptr || robot_ == nullptr || traj_ == nullptr)
 		return;
 
-	int index = traj_->getIndex(traj_time_);
-	if (index == -1)
+	if (traj_->size() == 0)
 		return;
 
-	const Pose2dWithTrajectory& pose = (*traj_)[index];
+	Pose2dWithTrajectory pose = traj_->sample(traj_time_);
 	drawRobot(paint, pose.pose(), QColor(0, 153, 0), QColor(255, 128, 0));
 }
 
 void PathFieldView::drawRobot(QPainter& paint, const Pose2dWithRotation& pose, QColor body, QColor wheel)
 {
 	Translation2d fl, fr, bl, br;
-	robot_->getLocations(path_->units(), fl, fr, bl, br);
+	robot_->getLocations(path_->unit(), fl, fr, bl, br);
 	fl = fl.rotateBy(pose.getSwrot());
 	fr = fr.rotateBy(pose.getSwrot());
 	bl = bl.rotateBy(pose.getSwrot());
@@ -672,6 +673,13 @@ void PathFieldView::drawSplines(QPainter& paint)
 		drawSpline(paint, splines[i]);
 }
 
+void PathFieldView::splineParams(double step, std::vector<double>& params)
+{
+	params.clear();
+	for (int i = 0; i * step < 1.0; i++)
+		params.push_back(i * step);
+}
+
 void PathFieldView::findSplineStep(std::shared_ptr<SplinePair> pair)
 {
 	double step = 0.1;
@@ -679,17 +687,22 @@ void PathFieldView::findSplineStep(std::shared_ptr<SplinePair> pair)
 	double nx, ny;
 	QPointF current, prev;
 
+	std::vector<double>& params = spline_params_;
+	SplineSamples& samples = spline_samples_;
+
 	while (true) {
 		bool first = true;
 		double maxdist = 0.0;
 
-		for (double t = 0.0; t < 1.0; t += step) {
+		splineParams(step, params);
+		pair->evalBatch(params, samples);
+
+		for (size_t i = 0; i < params.size(); i++) {
 
-			Translation2d loc = pair->evalPosition(t);
-			Rotation2d heading = pair->evalHeading(t);
+			Rotation2d heading(samples.dx[i], samples.dy[i], true);
 
-			cx = loc.getX() - robot_width_ * heading.getSin() / 2.0;
-			cy = loc.getY() + robot_width_ * heading.getCos() / 2.0;
+			cx = samples.x[i] - robot_width_ * heading.getSin() / 2.0;
+			cy = samples.y[i] + robot_width_ * heading.getCos() / 2.0;
 
 			current = worldToWindow(QPointF(cx, cy));
 
@@ -731,19 +744,24 @@ void PathFieldView::drawSpline(QPainter& paint, std::shared_ptr<SplinePair> pair
 	if (!pair->hasStep())
 		findSplineStep(pair);
 
-	for (float t = 0.0f; t < 1.0f; t += pair->step())
+	std::vector<double>& params = spline_params_;
+	SplineSamples& samples = spline_samples_;
+
+	splineParams(pair->step(), params);
+	pair->evalBatch(params, samples);
+
+	for (size_t i = 0; i < params.size(); i++)
 	{
-		Translation2d loc = pair->evalPosition(t);
-		Rotation2d heading = pair->evalHeading(t);
+		Rotation2d heading(samples.dx[i], samples.dy[i], true);
 
-		px = loc.getX() - robot_width_ * heading.getSin() / 2.0;
-		py = loc.getY() + robot_width_ * heading.getCos() / 2.0;
+		px = samples.x[i] - robot_width_ * heading.getSin() / 2.0;
+		py = samples.y[i] + robot_width_ * heading.getCos() / 2.0;
 
 		QPointF qp = worldToWindow(QPointF(px, py));
 		paint.drawPoint(qp);
 
-		px = loc.getX() + robot_width_ * heading.getSin() / 2.0;
-		py = loc.getY() - robot_width_ * heading.getCos() / 2.0;
+		px = samples.x[i] + robot_width_ * heading.getSin() / 2.0;
+		py = samples.y[i] - robot_width_ * heading.getCos() / 2.0;
 
 		qp = worldToWindow(QPointF(px, py));
 		paint.drawPoint(qp);
@@ -805,13 +823,13 @@ void PathFieldView::setRobot(std::shared_ptr<RobotParams> params)
 	robot_ = params;
 
 	if (robot_ != nullptr) {
-		robot_width_ = UnitConverter::convert(robot_->getBumberWidth(), robot_->getLengthUnits(), units_);
-		robot_length_ = UnitConverter::convert(robot_->getBumberLength(), robot_->getLengthUnits(), units_);
+		robot_width_ = UnitConverter::convert(robot_->getBumberWidth(), robot_->getLengthUnit(), unit_);
+		robot_length_ = UnitConverter::convert(robot_->getBumberLength(), robot_->getLengthUnit(), unit_);
 		drive_type_ = robot_->getDriveType();
 	}
 	else {
-		robot_width_ = UnitConverter::convert(28.0, "in", units_);
-		robot_width_ = UnitConverter::convert(28.0, "in", units_);
+		robot_width_ = UnitConverter::convert(28.0, UnitConverter::Unit::Inches, unit_);
+		robot_length_ = UnitConverter::convert(28.0, UnitConverter::Unit::Inches, unit_);
 		drive_type_ = RobotParams::DriveType::SwerveDrive;
 	}
 }
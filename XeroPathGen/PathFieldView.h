@@ -26,6 +26,7 @@
 #include <QPixmap>
 #include <QTransform>
 #include <memory>
+#include <vector>
 
 class PathFileTreeModel;
 
@@ -129,6 +130,7 @@ private:
 	void pasteCoordinates(bool rot180);
 
 	void findSplineStep(std::shared_ptr<SplinePair> pair);
+	static void splineParams(double step, std::vector<double>& params);
 
 	void pathChanged(const QString& grname, const QString& pathname);
 
@@ -166,7 +168,7 @@ private:
 	QTransform window_to_world_;
 	std::shared_ptr<RobotParams> robot_;
 	int selected_;
-	QString units_;
+	UnitConverter::Unit unit_;
 	bool dragging_;
 	bool rotating_;
 	bool heading_;
@@ -184,4 +186,11 @@ private:
 
 	std::shared_ptr<PathTrajectory> traj_;
 	double traj_time_;
+
+	//
+	// The spline parameters and samples used to draw each spline, kept so drawing the
+	// splines does not allocate them again for every segment
+	//
+	std::vector<double> spline_params_;
+	SplineSamples spline_samples_;
 };
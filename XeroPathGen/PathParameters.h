@@ -65,12 +65,13 @@ public:
 		return max_accel_;
 	}
 
-	void convert(const QString& from, const QString& to) {
+	void convert(UnitConverter::Unit from, UnitConverter::Unit to) {
 		if (from != to) {
-			start_velocity_ = UnitConverter::convert(start_velocity_, from, to);
-			end_velocity_ = UnitConverter::convert(end_velocity_, from, to);
-			max_velocity_ = UnitConverter::convert(max_velocity_, from, to);
-			max_accel_ = UnitConverter::convert(max_accel_, from, to);
+			double factor = UnitConverter::factor(from, to);
+			start_velocity_ *= factor;
+			end_velocity_ *= factor;
+			max_velocity_ *= factor;
+			max_accel_ *= factor;
 		}
 	}
 
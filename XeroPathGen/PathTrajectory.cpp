@@ -15,29 +15,204 @@
 //
 #include "PathTrajectory.h"
 #include <cmath>
+#include <algorithm>
 
-int PathTrajectory::getIndex(double time)
+PathTrajectory::PathTrajectory(const QString& name, const QVector<Pose2dWithTrajectory>& pts)
 {
-	if (size() == 0)
-		return std::numeric_limits<int>::max();
+	name_ = name;
+
+	time_.reserve(pts.size());
+	position_.reserve(pts.size());
+	velocity_.reserve(pts.size());
+	acceleration_.reserve(pts.size());
+	x_.reserve(pts.size());
+	y_.reserve(pts.size());
+	heading_cos_.reserve(pts.size());
+	heading_sin_.reserve(pts.size());
+	swrot_cos_.reserve(pts.size());
+	swrot_sin_.reserve(pts.size());
+	curvature_.reserve(pts.size());
+	rotvel_.reserve(pts.size());
+
+	for (const Pose2dWithTrajectory& pt : pts) {
+		time_.push_back(pt.time());
+		position_.push_back(pt.position());
+		velocity_.push_back(pt.velocity());
+		acceleration_.push_back(pt.acceleration());
+		x_.push_back(pt.x());
+		y_.push_back(pt.y());
+		heading_cos_.push_back(pt.rotation().getCos());
+		heading_sin_.push_back(pt.rotation().getSin());
+		swrot_cos_.push_back(pt.swrot().getCos());
+		swrot_sin_.push_back(pt.swrot().getSin());
+		curvature_.push_back(pt.curvature());
+		rotvel_.push_back(pt.rotVel());
+	}
+
+	findTimeStep();
+}
+
+void PathTrajectory::findTimeStep()
+{
+	time_step_ = 0.0;
 
-	if (time < points_.front().time())
-		return std::numeric_limits<int>::max();
+	if (size() < 2)
+		return;
 
-	if (time > points_.back().time())
-		return std::numeric_limits<int>::max();
+	double step = (time_.back() - time_.front()) / (size() - 1);
+	if (step <= 0.0)
+		return;
 
-	double delta = std::numeric_limits<double>::max();
-	int ret = 0;
-	for (int i = 0; i < size(); i++)
+	for (int i = 1; i < size(); i++)
 	{
-		double dt = std::fabs(points_[i].time() - time);
-		if (dt < delta)
-		{
-			delta = dt;
-			ret = i;
-		}
+		double expected = time_.front() + i * step;
+		if (std::fabs(time_[i] - expected) > step * kTimeStepTolerance)
+			return;
+	}
+
+	time_step_ = step;
+}
+
+int PathTrajectory::findInterval(double time) const
+{
+	//
+	// Returns the index of the point at the start of the interval that holds the time, so
+	// time_[index] <= time <= time_[index + 1].  The time must be inside the trajectory and
+	// the trajectory must have at least two points.
+	//
+	int last = size() - 2;
+	int index;
+
+	if (time_step_ > 0.0)
+	{
+		index = static_cast<int>((time - time_.front()) / time_step_);
+		index = std::clamp(index, 0, last);
+
+		//
+		// The times are within round off of the fixed step, so the index may be one off
+		//
+		while (index > 0 && time_[index] > time)
+			index--;
+
+		while (index < last && time_[index + 1] < time)
+			index++;
+	}
+	else
+	{
+		auto it = std::upper_bound(time_.begin(), time_.end(), time);
+		index = static_cast<int>(it - time_.begin()) - 1;
+		index = std::clamp(index, 0, last);
+	}
+
+	return index;
+}
+
+Pose2dWithTrajectory PathTrajectory::operator[](int index) const
+{
+	Pose2dWithRotation pose(Translation2d(x_[index], y_[index]), Rotation2d(heading_cos_[index], heading_sin_[index], false),
+		Rotation2d(swrot_cos_[index], swrot_sin_[index], false), curvature_[index]);
+
+	Pose2dWithTrajectory pt(pose, time_[index], position_[index], velocity_[index], acceleration_[index]);
+	pt.setRotVel(rotvel_[index]);
+
+	return pt;
+}
+
+QVector<double> PathTrajectory::column(const QString& field) const
+{
+	QVector<double> ret;
+
+	if (field == "x")
+	{
+		ret = x_;
+	}
+	else if (field == "y")
+	{
+		ret = y_;
+	}
+	else if (field == "heading")
+	{
+		ret.resize(size());
+		for (int i = 0; i < size(); i++)
+			ret[i] = Rotation2d(heading_cos_[i], heading_sin_[i], false).toDegrees();
+	}
+	else if (field == "time")
+	{
+		ret = time_;
+	}
+	else if (field == "position")
+	{
+		ret = position_;
 	}
+	else if (field == "velocity")
+	{
+		ret = velocity_;
+	}
+	else if (field == "acceleration")
+	{
+		ret = acceleration_;
+	}
+	else if (field == "curvature")
+	{
+		ret = curvature_;
+	}
+	else if (field == "rotation")
+	{
+		ret.resize(size());
+		for (int i = 0; i < size(); i++)
+			ret[i] = Rotation2d(swrot_cos_[i], swrot_sin_[i], false).toDegrees();
+	}
+	else if (field == "swrotvel")
+	{
+		ret = rotvel_;
+	}
+	else
+	{
+		ret.fill(std::nan(""), size());
+	}
+
+	return ret;
+}
+
+int PathTrajectory::getIndex(double time) const
+{
+	if (size() == 0)
+		return -1;
+
+	if (time < time_.front() || time > time_.back())
+		return -1;
+
+	if (size() == 1)
+		return 0;
+
+	int index = findInterval(time);
+
+	//
+	// On a tie the earlier point is the closest
+	//
+	if (std::fabs(time_[index + 1] - time) < std::fabs(time - time_[index]))
+		index++;
+
+	return index;
+}
+
+Pose2dWithTrajectory PathTrajectory::sample(double time) const
+{
+	if (size() == 0)
+		return Pose2dWithTrajectory();
+
+	if (size() == 1 || time <= time_.front())
+		return (*this)[0];
+
+	if (time >= time_.back())
+		return (*this)[size() - 1];
+
+	int index = findInterval(time);
+	double dt = time_[index + 1] - time_[index];
+	double percent = (dt > 0.0) ? (time - time_[index]) / dt : 0.0;
+
+	Pose2dWithTrajectory ret = (*this)[index].interpolate((*this)[index + 1], percent);
+	ret.setRotVel((rotvel_[index + 1] - rotvel_[index]) * percent + rotvel_[index]);
 
 	return ret;
 }
@@ -50,9 +225,9 @@ bool PathTrajectory::getTimeForDistance(double dist, double& time)
 	if (dist < 0.0)
 		return false;
 
-	if (dist > points_.back().position())
+	if (dist > position_.back())
 	{
-		time = points_.back().time();
+		time = time_.back();
 		return true;
 	}
 
@@ -60,12 +235,12 @@ bool PathTrajectory::getTimeForDistance(double dist, double& time)
 	// Do a binary search to find the time for the distance given
 	//
 	int low = 0;
-	int high = points_.size() - 1;
+	int high = size() - 1;
 
 	while (high - low > 1)
 	{
 		int mid = (high + low) / 2;
-		if (dist > points_[mid].position())
+		if (dist > position_[mid])
 		{
 			low = mid;
 		}
@@ -75,9 +250,8 @@ bool PathTrajectory::getTimeForDistance(double dist, double& time)
 		}
 	}
 
-	double pcnt = (dist - points_[low].position()) / (points_[high].position() - points_[low].position());
-	Pose2dWithTrajectory pt = points_[low].interpolate(points_[high], pcnt);
+	double pcnt = (dist - position_[low]) / (position_[high] - position_[low]);
 
-	time = pt.time();
+	time = (time_[high] - time_[low]) * pcnt + time_[low];
 	return true;
 }
@@ -19,70 +19,194 @@
 #include <QtCore/QVector>
 #include <QtCore/QString>
 
+//
+// A trajectory is stored by column, one array per value, so code that only needs
+// some of the values, like a plot or the CSV writer, only reads those values.
+// Indexing a trajectory returns a copy of a single point for code that wants to
+// work with whole points.
+//
 class PathTrajectory
 {
+	friend class TrajectoryDiskCache;
+
 public:
-	PathTrajectory(const QString &name, const QVector<Pose2dWithTrajectory>& pts) {
-		name_ = name;
-		points_ = pts;
+	PathTrajectory(const QString &name, const QVector<Pose2dWithTrajectory>& pts);
+
+	class const_iterator
+	{
+	public:
+		const_iterator(const PathTrajectory* traj, int index) {
+			traj_ = traj;
+			index_ = index;
+		}
+
+		Pose2dWithTrajectory operator*() const {
+			return (*traj_)[index_];
+		}
+
+		const_iterator& operator++() {
+			index_++;
+			return *this;
+		}
+
+		const_iterator operator++(int) {
+			const_iterator ret = *this;
+			index_++;
+			return ret;
+		}
+
+		bool operator==(const const_iterator& other) const {
+			return traj_ == other.traj_ && index_ == other.index_;
+		}
+
+		bool operator!=(const const_iterator& other) const {
+			return !(*this == other);
+		}
+
+	private:
+		const PathTrajectory* traj_;
+		int index_;
+	};
+
+	const_iterator begin() const {
+		return const_iterator(this, 0);
 	}
-	typedef QVector<Pose2dWithTrajectory>::iterator iterator;
-	typedef QVector<Pose2dWithTrajectory>::const_iterator const_iterator;
 
-	iterator begin() {
-		return points_.begin();
+	const_iterator end() const {
+		return const_iterator(this, size());
 	}
 
-	iterator end() {
-		return points_.end();
+	int size() const {
+		return time_.size();
 	}
 
-	const_iterator begin() const {
-		return points_.begin();
+	Pose2dWithTrajectory operator[](int index) const;
+
+	const QString& name() const {
+		return name_;
 	}
 
-	const_iterator end() const {
-		return points_.end();
+	//
+	// The values of a single field, using the same field names as Pose2dWithTrajectory::getField()
+	//
+	QVector<double> column(const QString& field) const;
+
+	const QVector<double>& times() const {
+		return time_;
 	}
 
-	int size() const {
-		return points_.size();
+	const QVector<double>& positions() const {
+		return position_;
 	}
 
-	const Pose2dWithTrajectory& operator[](int index) const {
-		return points_[index];
+	const QVector<double>& velocities() const {
+		return velocity_;
 	}
 
-	Pose2dWithTrajectory& operator[](int index) {
-		return points_[index];
+	const QVector<double>& accelerations() const {
+		return acceleration_;
 	}
 
-	const QString& name() const {
-		return name_;
+	const QVector<double>& xs() const {
+		return x_;
 	}
 
-	int getIndex(double time);
+	const QVector<double>& ys() const {
+		return y_;
+	}
+
+	const QVector<double>& headingCos() const {
+		return heading_cos_;
+	}
+
+	const QVector<double>& headingSin() const {
+		return heading_sin_;
+	}
+
+	const QVector<double>& swrotCos() const {
+		return swrot_cos_;
+	}
+
+	const QVector<double>& swrotSin() const {
+		return swrot_sin_;
+	}
+
+	const QVector<double>& curvatures() const {
+		return curvature_;
+	}
+
+	const QVector<double>& rotVels() const {
+		return rotvel_;
+	}
+
+	void setSwrot(int index, const Rotation2d& rot) {
+		swrot_cos_[index] = rot.getCos();
+		swrot_sin_[index] = rot.getSin();
+	}
+
+	void setRotVel(int index, double v) {
+		rotvel_[index] = v;
+	}
+
+	//
+	// The index of the point closest to the given time, or -1 if the time is outside of
+	// the trajectory or the trajectory is empty.  A trajectory with a fixed time step, like the ones
+	// from convertToUniformTime(), finds the index directly, any other trajectory uses
+	// a binary search.
+	//
+	int getIndex(double time) const;
+
+	//
+	// The state of the robot at the given time, interpolated between the two points
+	// around the time.  The time is clamped to the start and end of the trajectory.
+	//
+	Pose2dWithTrajectory sample(double time) const;
 
 	bool getTimeForDistance(double dist, double& time);
 
 	double getEndTime() const {
-		if (points_.size() == 0)
+		if (time_.size() == 0)
 			return 0.0;
 
-		return points_[points_.size() - 1].time();
+		return time_.back();
 	}
 
 	double getEndDistance() const {
-		if (points_.size() == 0)
+		if (position_.size() == 0)
 			return 0.0;
 
-		return points_[points_.size() - 1].position();
+		return position_.back();
 	}
 
 	double getDistance(int index);
 
+private:
+	PathTrajectory(const QString& name) {
+		name_ = name;
+		time_step_ = 0.0;
+	}
+
+	void findTimeStep();
+	int findInterval(double time) const;
+
+private:
+	static constexpr double kTimeStepTolerance = 1e-6;
+
 private:
 	QString name_;
-	QVector<Pose2dWithTrajectory> points_;
-	QVector<double> distances_;
+	QVector<double> time_;
+	QVector<double> position_;
+	QVector<double> velocity_;
+	QVector<double> acceleration_;
+	QVector<double> x_;
+	QVector<double> y_;
+	QVector<double> heading_cos_;
+	QVector<double> heading_sin_;
+	QVector<double> swrot_cos_;
+	QVector<double> swrot_sin_;
+	QVector<double> curvature_;
+	QVector<double> rotvel_;
+
+	// The time between points if it is the same for every point, otherwise zero
+	double time_step_;
 };
\ No newline at end of file
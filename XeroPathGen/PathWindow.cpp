@@ -301,7 +301,7 @@ void PathWindow::addPath()
 	// The initialize waypoints are 0, 0, and 0, 1 m, but the 1 meter is
 	// converted to the units being used by the path data model
 	//
-	double xval = UnitConverter::convert(1.0, "m", model_.units());
+	double xval = UnitConverter::convert(1.0, UnitConverter::Unit::Meters, path->unit());
 
 	path->addWayPoint(Pose2dWithRotation(Translation2d(0, 0), Rotation2d::fromDegrees(0.0), Rotation2d::fromDegrees(0.0)));
 	path->addWayPoint(Pose2dWithRotation(Translation2d(xval , 0), Rotation2d::fromDegrees(0.0), Rotation2d::fromDegrees(0.0)));
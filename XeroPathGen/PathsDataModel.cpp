@@ -35,6 +35,7 @@ PathsDataModel::PathsDataModel(GenerationMgr& genmgr) : gen_mgr_(genmgr)
 	default_units_ = "m";
 	gen_type_ = GeneratorType::None;
 	generation_enabled_ = true;
+	preview_enabled_ = false;
 }
 
 PathsDataModel::~PathsDataModel()
@@ -281,6 +282,7 @@ void PathsDataModel::enableGeneration(bool b)
 		for (auto path : deferred_) {
 			gen_mgr_.addPath(gen_type_, path);
 		}
+		deferred_.clear();
 	}
 	else
 	{
@@ -288,13 +290,43 @@ void PathsDataModel::enableGeneration(bool b)
 	}
 }
 
+void PathsDataModel::enablePreview(bool b)
+{
+	if (b)
+	{
+		preview_enabled_ = true;
+	}
+	else
+	{
+		//
+		// The path has stopped changing, so replace the previews with full
+		// quality trajectories
+		//
+		preview_enabled_ = false;
+		if (generation_enabled_) {
+			for (auto path : deferred_) {
+				gen_mgr_.addPath(gen_type_, path);
+			}
+			deferred_.clear();
+		}
+	}
+}
+
 void PathsDataModel::generateTrajectory(std::shared_ptr<RobotPath> path)
 {
-	if (generation_enabled_) {
-		gen_mgr_.addPath(gen_type_, path);
+	if (!generation_enabled_) {
+		if (!deferred_.contains(path)) {
+			deferred_.push_back(path);
+		}
+	}
+	else if (preview_enabled_) {
+		gen_mgr_.addPath(gen_type_, path, true);
+		if (!deferred_.contains(path)) {
+			deferred_.push_back(path);
+		}
 	}
 	else {
-		deferred_.push_back(path);
+		gen_mgr_.addPath(gen_type_, path);
 	}
 }
 
@@ -571,9 +603,12 @@ QJsonObject PathsDataModel::modelToObject()
 void PathsDataModel::convert(const QString& units)
 {
 	if (units != units_) {
+		UnitConverter::Unit from = UnitConverter::toUnit(units_);
+		UnitConverter::Unit to = UnitConverter::toUnit(units);
+
 		for (auto gr : groups_) {
 			for (auto path : gr->paths()) {
-				path->convert(units_, units);
+				path->convert(from, to);
 			}
 		}
 
@@ -39,6 +39,7 @@ public:
 
 
 	void enableGeneration(bool);
+	void enablePreview(bool);
 
 	void setGeneratorType(GeneratorType type, bool undoentry = true) {
 		if (undoentry) {
@@ -182,6 +183,7 @@ private:
 
 	QVector<std::shared_ptr<RobotPath>> deferred_;
 	bool generation_enabled_;
+	bool preview_enabled_;
 
 	// The list of undoable actions
 	QVector<std::shared_ptr<UndoAction>> undo_stack_;
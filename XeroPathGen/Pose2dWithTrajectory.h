@@ -26,6 +26,7 @@ public:
 		position_ = 0.0;
 		velocity_ = 0.0;
 		acceleration_ = 0.0;
+		rotvel_ = 0.0;
 	}
 
 	Pose2dWithTrajectory(const Pose2dWithRotation& pose, double time, double pos, double vel, double acc) {
@@ -34,6 +35,7 @@ public:
 		position_ = pos;
 		velocity_ = vel;
 		acceleration_ = acc;
+		rotvel_ = 0.0;
 	}
 
 	virtual ~Pose2dWithTrajectory() {
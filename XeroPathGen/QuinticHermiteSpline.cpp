@@ -37,22 +37,59 @@ void QuinticHermiteSpline::compute()
 	f_ = v0_;
 }
 
-double QuinticHermiteSpline::eval(double t)
+double QuinticHermiteSpline::eval(double t) const
 {
-	return a() * t * t * t * t * t + b() * t * t * t * t + c() * t * t * t + d() * t * t + e() * t + f();
+	return ((((a_ * t + b_) * t + c_) * t + d_) * t + e_) * t + f_;
 }
 
-double QuinticHermiteSpline::derivative(double t)
+double QuinticHermiteSpline::derivative(double t) const
 {
-	return 5 * a() * t * t * t * t + 4 * b() * t * t * t + 3 * c() * t * t + 2 * d() * t + e();
+	return (((5 * a_ * t + 4 * b_) * t + 3 * c_) * t + 2 * d_) * t + e_;
 }
 
-double QuinticHermiteSpline::derivative2(double t)
+double QuinticHermiteSpline::derivative2(double t) const
 {
-	return 20 * a() * t * t * t + 12 * b() * t * t + 6 * c() * t + 2 * d();
+	return ((20 * a_ * t + 12 * b_) * t + 6 * c_) * t + 2 * d_;
 }
 
-double QuinticHermiteSpline::derivative3(double t)
+double QuinticHermiteSpline::derivative3(double t) const
 {
-	return 60 * a() * t * t + 24 * b() * t + 6 * c();
+	return (60 * a_ * t + 24 * b_) * t + 6 * c_;
+}
+
+void QuinticHermiteSpline::evalBatch(std::span<const double> t, std::span<double> v, std::span<double> dv, std::span<double> ddv) const
+{
+	assert(v.empty() || v.size() == t.size());
+	assert(dv.empty() || dv.size() == t.size());
+	assert(ddv.empty() || ddv.size() == t.size());
+
+	//
+	// The coefficients are copied to locals so the compiler knows the stores to the
+	// outputs do not change them
+	//
+	const double a = a_, b = b_, c = c_, d = d_, e = e_, f = f_;
+	const size_t count = t.size();
+
+	if (!v.empty()) {
+		for (size_t i = 0; i < count; i++) {
+			double ti = t[i];
+			v[i] = ((((a * ti + b) * ti + c) * ti + d) * ti + e) * ti + f;
+		}
+	}
+
+	if (!dv.empty()) {
+		const double a1 = 5 * a, b1 = 4 * b, c1 = 3 * c, d1 = 2 * d;
+		for (size_t i = 0; i < count; i++) {
+			double ti = t[i];
+			dv[i] = (((a1 * ti + b1) * ti + c1) * ti + d1) * ti + e;
+		}
+	}
+
+	if (!ddv.empty()) {
+		const double a2 = 20 * a, b2 = 12 * b, c2 = 6 * c, d2 = 2 * d;
+		for (size_t i = 0; i < count; i++) {
+			double ti = t[i];
+			ddv[i] = ((a2 * ti + b2) * ti + c2) * ti + d2;
+		}
+	}
 }
@@ -15,16 +15,27 @@
 //
 #pragma once
 #include <vector>
+#include <span>
 
 class QuinticHermiteSpline
 {
 public:
+	QuinticHermiteSpline() : QuinticHermiteSpline(0.0, 0.0, 0.0, 0.0, 0.0, 0.0) {
+	}
+
 	QuinticHermiteSpline(double v0, double v1, double dv0, double dv1, double ddv0, double ddv1);
 
-	double eval(double t);
-	double derivative(double t);
-	double derivative2(double t);
-	double derivative3(double t);
+	double eval(double t) const;
+	double derivative(double t) const;
+	double derivative2(double t) const;
+	double derivative3(double t) const;
+
+	//
+	// Evaluates the spline and its first two derivatives at every value of t.  An output
+	// that is not needed may be left empty, otherwise it must be the same size as t.  Each
+	// output is computed in its own loop so the compiler can vectorize it.
+	//
+	void evalBatch(std::span<const double> t, std::span<double> v, std::span<double> dv, std::span<double> ddv) const;
 
 	double v0() { return v0_; }
 	double v1() { return v1_; }
@@ -67,8 +67,8 @@ public:
 		ewidth_ = DefaultWidth;
 		max_velocity_ = DefaultMaxVelocity;
 		max_acceleration_ = DefaultMaxAcceleration;
-		length_units_ = "in";
-		weight_units_ = "lbs";
+		setLengthUnits("in");
+		setWeightUnits("lbs");
 		timestep_ = 0.02;
 	}
 
@@ -105,10 +105,12 @@ public:
 
 	void setLengthUnits(const QString& units) {
 		length_units_ = units;
+		length_unit_ = UnitConverter::toUnit(units);
 	}
 
 	void setWeightUnits(const QString& units) {
 		weight_units_ = units;
+		weight_unit_ = UnitConverter::toUnit(units);
 	}
 
 	const QString& getLengthUnits() const {
@@ -119,14 +121,25 @@ public:
 		return weight_units_;
 	}
 
+	UnitConverter::Unit getLengthUnit() const {
+		return length_unit_;
+	}
+
+	UnitConverter::Unit getWeightUnit() const {
+		return weight_unit_;
+	}
+
 	void convert(const QString& units) {
-		elength_ = UnitConverter::convert(elength_, length_units_, units);
-		ewidth_ = UnitConverter::convert(ewidth_, length_units_, units);
-		rlength_ = UnitConverter::convert(rlength_, length_units_, units);
-		rwidth_ = UnitConverter::convert(rwidth_, length_units_, units);
-		max_velocity_ = UnitConverter::convert(max_velocity_, length_units_, units);
-		max_acceleration_ = UnitConverter::convert(max_acceleration_, length_units_, units);
-		length_units_ = units;
+		if (units != length_units_) {
+			double factor = UnitConverter::factor(length_unit_, UnitConverter::toUnit(units));
+			elength_ *= factor;
+			ewidth_ *= factor;
+			rlength_ *= factor;
+			rwidth_ *= factor;
+			max_velocity_ *= factor;
+			max_acceleration_ *= factor;
+		}
+		setLengthUnits(units);
 	}
 
 	double getWheelBaseWidth() const {
@@ -193,9 +206,9 @@ public:
 		timestep_ = v;
 	}
 
-	void getLocations(const QString &units, Translation2d& fl, Translation2d& fr, Translation2d& bl, Translation2d& br) {
-		double width = UnitConverter::convert(rwidth_, length_units_, units);
-		double length = UnitConverter::convert(rlength_, length_units_, units);
+	void getLocations(UnitConverter::Unit units, Translation2d& fl, Translation2d& fr, Translation2d& bl, Translation2d& br) {
+		double width = UnitConverter::convert(rwidth_, length_unit_, units);
+		double length = UnitConverter::convert(rlength_, length_unit_, units);
 
 		fl = Translation2d(width / 2.0, length / 2.0);
 		fr = Translation2d(width / 2.0, -length / 2.0);
@@ -213,6 +226,8 @@ private:
 	double max_acceleration_;
 	QString length_units_;
 	QString weight_units_;
+	UnitConverter::Unit length_unit_;
+	UnitConverter::Unit weight_unit_;
 	QString name_;
 	DriveType drivetype_;
 	QString filename_;
@@ -28,20 +28,26 @@
 #include <QtCore/QJsonArray>
 #include <limits>
 
+std::atomic<qint64> RobotPath::next_geometry_revision_ = 1;
+
 RobotPath::RobotPath(const PathGroup* gr, const QString& units, const QString &name, const PathParameters &params)
 {
+	geometryChanged();
 	group_ = gr;
 	name_ = name;
 	params_ = params;
 	units_ = units;
+	unit_ = UnitConverter::toUnit(units);
 }
 
 RobotPath::RobotPath(const PathGroup* gr, const QString &name, const RobotPath& other)
 {
+	geometryChanged();
 	group_ = gr;
 	name_ = name;
 	params_ = other.params_;
 	units_ = other.units_;
+	unit_ = other.unit_;
 
 	for (const Pose2dWithRotation& pt : other.waypoints()) {
 		addWayPoint(pt);
@@ -52,7 +58,40 @@ RobotPath::RobotPath(const PathGroup* gr, const QString &name, const RobotPath&
 	}
 }
 
+std::shared_ptr<RobotPath> RobotPath::snapshot() const
+{
+	//
+	// The constraints of the copy point back at it.  So the two are not kept alive by
+	// each other, the copy is handed out through a holder that lets go of the constraints
+	// when the last user of the copy is done with it.
+	//
+	struct Holder
+	{
+		std::shared_ptr<RobotPath> path;
+
+		~Holder() {
+			path->constraints_.clear();
+		}
+	};
+
+	auto holder = std::make_shared<Holder>();
+	holder->path = std::make_shared<RobotPath>(nullptr, units_, fullname(), params_);
+
+	RobotPath* copy = holder->path.get();
+	copy->waypoints_ = waypoints_;
+	copy->geometry_revision_ = geometry_revision_.load();
+	for (const std::shared_ptr<PathConstraint> con : constraints_) {
+		copy->constraints_.push_back(con->clone(holder->path));
+	}
+
+	return std::shared_ptr<RobotPath>(holder, copy);
+}
+
 QString RobotPath::fullname() const {
+	if (group_ == nullptr) {
+		return name_;
+	}
+
 	return group_->name() + "-" + name_;
 }
 
@@ -76,6 +115,7 @@ void RobotPath::replacePoint(int index, const Pose2dWithRotation& pt, bool undoe
 		emitBeforePathChangedSignal(std::make_shared<UndoChangeWaypoint>(index, waypoints_[index], shared_from_this()));
 	}
 	waypoints_[index] = pt;
+	geometryChanged();
 	emitAfterPathChangedSignal();
 }
 
@@ -85,6 +125,7 @@ void RobotPath::removePoint(int index, bool undoentry)
 		emitBeforePathChangedSignal(std::make_shared<UndoRemovePoint>(index, waypoints_[index], shared_from_this()));
 	}
 	waypoints_.remove(index, 1);
+	geometryChanged();
 	emitAfterPathChangedSignal();
 
 }
@@ -95,6 +136,7 @@ void RobotPath::insertPoint(int index, const Pose2dWithRotation& pt, bool undoen
 		emitBeforePathChangedSignal(std::make_shared<UndoInsertPoint>(index + 1, shared_from_this()));
 	}
 	waypoints_.insert(index + 1, pt);
+	geometryChanged();
 	emitAfterPathChangedSignal();
 }
 
@@ -135,27 +177,28 @@ void RobotPath::emitAfterPathChangedSignal()
 	emit afterPathChanged(group_->name(), name_);
 }
 
-void RobotPath::convert(const QString& from, const QString& to)
+void RobotPath::convert(UnitConverter::Unit fromunit, UnitConverter::Unit tounit)
 {
 	for (auto con : constraints_) {
-		con->convert(from, to);
+		con->convert(fromunit, tounit);
 	}
 
-	params_.convert(from, to);
+	params_.convert(fromunit, tounit);
 
 	bool save = signalsBlocked();
 	blockSignals(true);
 
 	for (int i = 0; i < size(); i++) {
 		const Pose2dWithRotation pt = getPoint(i);
-		double newx = UnitConverter::convert(pt.getTranslation().getX(), from, to);
-		double newy = UnitConverter::convert(pt.getTranslation().getY(), from, to);
+		double newx = UnitConverter::convert(pt.getTranslation().getX(), fromunit, tounit);
+		double newy = UnitConverter::convert(pt.getTranslation().getY(), fromunit, tounit);
 		Pose2dWithRotation newpt(Translation2d(newx, newy), pt.getRotation(), pt.getSwrot());
 
 		replacePoint(i, newpt);
 	}
 
-	units_ = to;
+	units_ = UnitConverter::toString(tounit);
+	unit_ = tounit;
 	
 	blockSignals(save);
 
@@ -18,12 +18,14 @@
 #include "Pose2dWithRotation.h"
 #include "PathConstraint.h"
 #include "PathParameters.h"
+#include "UnitConverter.h"
 
 #include <QtCore/QObject>
 #include <QtCore/QString>
 #include <QtCore/QVector>
 #include <QtCore/QJsonObject>
 #include <memory>
+#include <atomic>
 
 class PathGroup;
 class UndoAction;
@@ -76,6 +78,14 @@ public:
 	RobotPath(const PathGroup *gr, const QString &units, const QString &name, const PathParameters &params);
 	RobotPath(const PathGroup* gr, const QString &name, const RobotPath& other);
 
+	//
+	// A copy of the inputs to the generators, the waypoints, constraints, parameters and
+	// units, taken on the GUI thread so a generator can read it while the path is edited.
+	// The copy belongs to no group, has the same geometry revision as this path, and must
+	// not be changed.
+	//
+	std::shared_ptr<RobotPath> snapshot() const;
+
 	const QString& name() const {
 		return name_;
 	}
@@ -88,6 +98,10 @@ public:
 		return units_;
 	}
 
+	UnitConverter::Unit unit() const {
+		return unit_;
+	}
+
 	const PathParameters& params() const {
 		return params_;
 	}
@@ -104,6 +118,15 @@ public:
 
 	void addWayPoint(const Pose2dWithRotation& waypoint) {
 		waypoints_.push_back(waypoint);
+		geometryChanged();
+	}
+
+	//
+	// A number that changes whenever the waypoints of the path change.  The numbers are
+	// never reused, by this path or any other, so they identify the geometry of a path.
+	//
+	qint64 geometryRevision() const {
+		return geometry_revision_;
 	}
 
 	bool isEmpty() const {
@@ -137,7 +160,7 @@ public:
 		return constraints_;
 	}
 
-	void convert(const QString& from, const QString& to);
+	void convert(UnitConverter::Unit from, UnitConverter::Unit to);
 
 	static std::shared_ptr<RobotPath> fromJSONObject(const PathGroup *group, const QString &units, const QJsonObject& obj, QString &msg);
 	QJsonObject toJSONObject();
@@ -150,6 +173,10 @@ private:
 	void emitBeforePathChangedSignal(std::shared_ptr<UndoAction> action);
 	void emitAfterPathChangedSignal();
 
+	void geometryChanged() {
+		geometry_revision_ = next_geometry_revision_++;
+	}
+
 	static bool readPoints(std::shared_ptr<RobotPath> path, const QJsonArray& obj, QString &msg);
 	static bool readConstraints(std::shared_ptr<RobotPath> path, const QJsonArray& obj, QString &msg);
 	static double getDoubleParam(const QJsonObject& obj, const QString& tag, QString& msg);
@@ -164,4 +191,8 @@ private:
 	QVector<std::shared_ptr<PathConstraint>> constraints_;			// The set of constrains to apply to the path
 	PathParameters params_;											// The path velocity and acceleration parameters
 	QString units_;													// The units for this path
+	UnitConverter::Unit unit_;										// The units for this path, as a unit
+	std::atomic<qint64> geometry_revision_;							// Changes when the waypoints change, see geometryRevision()
+
+	static std::atomic<qint64> next_geometry_revision_;
 };
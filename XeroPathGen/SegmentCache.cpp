@@ -0,0 +1,48 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "SegmentCache.h"
+#include <QtCore/QDataStream>
+
+SegmentCache::SegmentCache(int maxentries) : entries_(maxentries)
+{
+}
+
+QByteArray SegmentCache::computeKey(const Pose2d& p0, const Pose2d& p1, double maxdx, double maxdy, double maxdtheta, double step)
+{
+	QByteArray data;
+	QDataStream strm(&data, QIODevice::WriteOnly);
+
+	strm.setByteOrder(QDataStream::LittleEndian);
+	strm.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+	//
+	// The key is small, so it is used as is rather than hashed
+	//
+	strm << p0.getTranslation().getX();
+	strm << p0.getTranslation().getY();
+	strm << p0.getRotation().getCos();
+	strm << p0.getRotation().getSin();
+	strm << p1.getTranslation().getX();
+	strm << p1.getTranslation().getY();
+	strm << p1.getRotation().getCos();
+	strm << p1.getRotation().getSin();
+	strm << maxdx;
+	strm << maxdy;
+	strm << maxdtheta;
+	strm << step;
+
+	return data;
+}
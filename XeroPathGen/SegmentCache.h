@@ -0,0 +1,64 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include "Pose2d.h"
+#include "Pose2dWithRotation.h"
+#include "LruCache.h"
+#include <QtCore/QByteArray>
+#include <QtCore/QVector>
+#include <memory>
+
+//
+// An in memory cache of the points generated for a single spline segment of a
+// path, the part of the path between two waypoints.  The key is the pose of the
+// two waypoints and the resolution used to generate the points, so when a single
+// waypoint is moved only the two segments that touch it are generated again.
+// The cache is shared by all of the generator threads.
+//
+class SegmentCache
+{
+public:
+	SegmentCache(int maxentries = DefaultMaxEntries);
+
+	static QByteArray computeKey(const Pose2d& p0, const Pose2d& p1, double maxdx, double maxdy, double maxdtheta, double step);
+
+	//
+	// Returns the points for the segment, evenly spaced by distance and including
+	// both ends, or nullptr if the key is not in the cache
+	//
+	std::shared_ptr<const QVector<Pose2dWithRotation>> find(const QByteArray& key) {
+		return entries_.find(key);
+	}
+
+	void insert(const QByteArray& key, std::shared_ptr<const QVector<Pose2dWithRotation>> points) {
+		entries_.insert(key, points);
+	}
+
+	void clear() {
+		entries_.clear();
+	}
+
+	int size() {
+		return entries_.size();
+	}
+
+private:
+	static constexpr int DefaultMaxEntries = 1024;
+
+private:
+	LruCache<QByteArray, std::shared_ptr<const QVector<Pose2dWithRotation>>> entries_;
+};
@@ -15,6 +15,7 @@
 //
 #include "SplinePair.h"
 #include <cmath>
+#include <algorithm>
 
 SplinePair::SplinePair(const Pose2d &p0, const Pose2d &p1)
 {
@@ -26,7 +27,7 @@ SplinePair::SplinePair(const Pose2d &p0, const Pose2d &p1)
 	double dx1 = p1.getRotation().getCos() * scale;
 	double ddx0 = 0.0;
 	double ddx1 = 0.0;
-	x_ = new QuinticHermiteSpline(x0, x1, dx0, dx1, ddx0, ddx1);
+	x_ = QuinticHermiteSpline(x0, x1, dx0, dx1, ddx0, ddx1);
 
 	double y0 = p0.getTranslation().getY();
 	double y1 = p1.getTranslation().getY();
@@ -34,39 +35,41 @@ SplinePair::SplinePair(const Pose2d &p0, const Pose2d &p1)
 	double dy1 = p1.getRotation().getSin() * scale;
 	double ddy0 = 0.0;
 	double ddy1 = 0.0;
-	y_ = new QuinticHermiteSpline(y0, y1, dy0, dy1, ddy0, ddy1);
+	y_ = QuinticHermiteSpline(y0, y1, dy0, dy1, ddy0, ddy1);
 
 	has_step_ = false;
 	step_ = 0.1;
+	has_length_ = false;
+	length_ = 0.0;
 }
 
 SplinePair::SplinePair(const QuinticHermiteSpline& x, const QuinticHermiteSpline& y)
 {
-	x_ = new QuinticHermiteSpline(x);
-	y_ = new QuinticHermiteSpline(y);
+	x_ = x;
+	y_ = y;
 
 	has_step_ = false;
 	step_ = 0.1;
+	has_length_ = false;
+	length_ = 0.0;
 }
 
 SplinePair::~SplinePair()
 {
-	delete x_;
-	delete y_;
 }
 
-Translation2d SplinePair::evalPosition(double t)
+Translation2d SplinePair::evalPosition(double t) const
 {
-	double xval = x_->eval(t);
-	double yval = y_->eval(t);
+	double xval = x_.eval(t);
+	double yval = y_.eval(t);
 
 	return Translation2d(xval, yval);
 }
 
-Rotation2d SplinePair::evalHeading(double t)
+Rotation2d SplinePair::evalHeading(double t) const
 {
-	double xval = x_->derivative(t);
-	double yval = y_->derivative(t);
+	double xval = x_.derivative(t);
+	double yval = y_.derivative(t);
 
 	return Rotation2d(xval, yval, true);
 }
@@ -90,12 +93,138 @@ double SplinePair::getDCurvature2(double t)
 	return num * num / (dx2dy2 * dx2dy2 * dx2dy2 * dx2dy2 * dx2dy2);
 }
 
-Pose2d SplinePair::getStartPose()
+void SplinePair::evalBatch(std::span<const double> t, SplineSamples& samples) const
+{
+	samples.resize(t.size());
+
+	x_.evalBatch(t, samples.x, samples.dx, samples.ddx);
+	y_.evalBatch(t, samples.y, samples.dy, samples.ddy);
+
+	const double* dx = samples.dx.data();
+	const double* dy = samples.dy.data();
+	const double* ddx = samples.ddx.data();
+	const double* ddy = samples.ddy.data();
+	double* curvature = samples.curvature.data();
+
+	for (size_t i = 0; i < t.size(); i++) {
+		double speed2 = dx[i] * dx[i] + dy[i] * dy[i];
+		curvature[i] = (dx[i] * ddy[i] - ddx[i] * dy[i]) / (speed2 * std::sqrt(speed2));
+	}
+}
+
+Pose2d SplinePair::getStartPose() const
 {
 	return Pose2d(evalPosition(0), evalHeading(0));
 }
 
-Pose2d SplinePair::getEndPose()
+Pose2d SplinePair::getEndPose() const
 {
 	return Pose2d(evalPosition(1), evalHeading(1));
 }
+
+double SplinePair::length()
+{
+	if (!has_length_)
+	{
+		double whole = gaussLegendre(0.0, 1.0);
+		length_ = adaptiveLength(0.0, 1.0, whole, kLengthTolerance * std::max(1.0, whole), kMaxLengthDepth);
+		has_length_ = true;
+	}
+
+	return length_;
+}
+
+void SplinePair::paramsByLength(double step, std::vector<double>& params)
+{
+	static const double kEpsilon = 1e-6;
+
+	double total = length();
+	int count = std::max(1, static_cast<int>(std::ceil(total / step - kEpsilon)));
+	double delta = total / count;
+	double tolerance = kLengthTolerance * std::max(1.0, delta);
+
+	params.clear();
+	params.reserve(count + 1);
+	params.push_back(0.0);
+
+	//
+	// Each parameter is found from the one before it, so the arc length is only ever
+	// integrated over a single short piece of the spline
+	//
+	double t = 0.0;
+	for (int i = 1; i < count; i++) {
+		t = paramForLength(t, delta, tolerance);
+		params.push_back(t);
+	}
+	params.push_back(1.0);
+}
+
+double SplinePair::paramForLength(double t0, double target, double tolerance)
+{
+	//
+	// Finds t where the arc length from t0 to t is target.  The arc length only grows with
+	// t, so the answer stays bracketed by [low, high], and a Newton step that leaves the
+	// bracket, or a point where the spline has no speed, falls back to bisection.
+	//
+	double low = t0;
+	double high = 1.0;
+	double v = speed(t0);
+	double t = (v > 0.0) ? std::min(t0 + target / v, high) : (low + high) / 2.0;
+
+	for (int i = 0; i < kMaxNewtonSteps; i++) {
+		double err = pieceLength(t0, t, tolerance) - target;
+		if (std::fabs(err) <= tolerance)
+			break;
+
+		if (err > 0.0)
+			high = t;
+		else
+			low = t;
+
+		v = speed(t);
+		double next = (v > 0.0) ? t - err / v : low - 1.0;
+		t = (next > low && next < high) ? next : (low + high) / 2.0;
+	}
+
+	return t;
+}
+
+double SplinePair::pieceLength(double t0, double t1, double tolerance)
+{
+	return adaptiveLength(t0, t1, gaussLegendre(t0, t1), tolerance, kMaxLengthDepth);
+}
+
+double SplinePair::gaussLegendre(double t0, double t1)
+{
+	//
+	// Five point Gauss-Legendre quadrature of the speed over [t0, t1]
+	//
+	static constexpr double nodes[] = { 0.0, 0.5384693101056831, 0.9061798459386640 };
+	static constexpr double weights[] = { 0.5688888888888889, 0.4786286704993665, 0.2369268850561891 };
+
+	double half = (t1 - t0) / 2.0;
+	double mid = (t1 + t0) / 2.0;
+
+	double sum = weights[0] * speed(mid);
+	for (int i = 1; i < 3; i++) {
+		sum += weights[i] * (speed(mid - half * nodes[i]) + speed(mid + half * nodes[i]));
+	}
+
+	return sum * half;
+}
+
+double SplinePair::adaptiveLength(double t0, double t1, double whole, double tolerance, int depth)
+{
+	//
+	// Split the interval in two and stop when the halves agree with the whole.  The speed of
+	// a quintic spline is smooth, so most splines stop after the first split.
+	//
+	double mid = (t0 + t1) / 2.0;
+	double left = gaussLegendre(t0, mid);
+	double right = gaussLegendre(mid, t1);
+
+	if (depth == 0 || std::fabs(left + right - whole) <= tolerance)
+		return left + right;
+
+	return adaptiveLength(t0, mid, left, tolerance / 2.0, depth - 1) + adaptiveLength(mid, t1, right, tolerance / 2.0, depth - 1);
+}
@@ -19,7 +19,33 @@
 #include "Translation2d.h"
 #include "Pose2d.h"
 #include <memory>
+#include <cmath>
 #include <vector>
+#include <span>
+
+//
+// The values of a spline pair at many parameters, stored one array per value
+//
+struct SplineSamples
+{
+	std::vector<double> x;
+	std::vector<double> y;
+	std::vector<double> dx;
+	std::vector<double> dy;
+	std::vector<double> ddx;
+	std::vector<double> ddy;
+	std::vector<double> curvature;
+
+	void resize(size_t count) {
+		x.resize(count);
+		y.resize(count);
+		dx.resize(count);
+		dy.resize(count);
+		ddx.resize(count);
+		ddy.resize(count);
+		curvature.resize(count);
+	}
+};
 
 class SplinePair
 {
@@ -28,48 +54,76 @@ public:
 	SplinePair(const QuinticHermiteSpline& x, const QuinticHermiteSpline& y);
 	virtual ~SplinePair();
 
+	//
+	// The caller may change the spline through the reference, so the length is found again
+	//
 	QuinticHermiteSpline& getX() {
-		return *x_;
+		has_length_ = false;
+		return x_;
 	}
 
 	QuinticHermiteSpline& getY() {
-		return *y_;
+		has_length_ = false;
+		return y_;
 	}
 
-	double x0() { return x_->v0(); }
-	double x1() { return x_->v0(); }
-	double dx0() { return x_->dv0(); }
-	double dx1() { return x_->dv1(); }
-	double ddx0() { return x_->ddv0(); }
-	double ddx1() { return x_->ddv1(); }
+	double x0() { return x_.v0(); }
+	double x1() { return x_.v0(); }
+	double dx0() { return x_.dv0(); }
+	double dx1() { return x_.dv1(); }
+	double ddx0() { return x_.ddv0(); }
+	double ddx1() { return x_.ddv1(); }
 
-	double y0() { return y_->v0(); }
-	double y1() { return y_->v0(); }
-	double dy0() { return y_->dv0(); }
-	double dy1() { return y_->dv1(); }
-	double ddy0() { return y_->ddv0(); }
-	double ddy1() { return y_->ddv1(); }
+	double y0() { return y_.v0(); }
+	double y1() { return y_.v0(); }
+	double dy0() { return y_.dv0(); }
+	double dy1() { return y_.dv1(); }
+	double ddy0() { return y_.ddv0(); }
+	double ddy1() { return y_.ddv1(); }
 
 	void ddxy0(double x, double y) {
-		x_->ddv0(x);
-		y_->ddv0(y);
+		x_.ddv0(x);
+		y_.ddv0(y);
+		has_length_ = false;
 	}
 
 	void ddxy1(double x, double y) {
-		x_->ddv1(x);
-		y_->ddv1(y);
+		x_.ddv1(x);
+		y_.ddv1(y);
+		has_length_ = false;
 	}
 
-	Translation2d evalPosition(double t);
-	Rotation2d evalHeading(double t);
-	Pose2d evalPose(double t) { return Pose2d(evalPosition(t), evalHeading(t)); }
+	Translation2d evalPosition(double t) const;
+	Rotation2d evalHeading(double t) const;
+	Pose2d evalPose(double t) const { return Pose2d(evalPosition(t), evalHeading(t)); }
+
+	//
+	// Evaluates the position, the first and second derivatives and the curvature at every
+	// value of t.  This is much faster than evaluating one t at a time when a caller needs
+	// many points along the spline.
+	//
+	void evalBatch(std::span<const double> t, SplineSamples& samples) const;
 
 	double getCurvature(double t);
 	double getDCurvature(double t);
 	double getDCurvature2(double t);
 
-	Pose2d getStartPose();
-	Pose2d getEndPose();
+	Pose2d getStartPose() const;
+	Pose2d getEndPose() const;
+
+	//
+	// The arc length of the spline, found with adaptive Gauss-Legendre quadrature.  The
+	// length is kept until the spline is changed.
+	//
+	double length();
+
+	//
+	// The parameters that split the spline into pieces of equal arc length, no longer
+	// than step, including both ends.  Each parameter is found by inverting the arc
+	// length function with Newton's method.  The parameters replace the contents of
+	// params, which keeps its capacity.
+	//
+	void paramsByLength(double step, std::vector<double>& params);
 
 	double sumDCurvature2() {
 		double dt = 1.0 / kSamples;
@@ -99,37 +153,53 @@ public:
 	}
 
 private:
-	double dx(double t) {
-		return x_->derivative(t);
+	double dx(double t) const {
+		return x_.derivative(t);
 	}
 
-	double ddx(double t) {
-		return x_->derivative2(t);
+	double ddx(double t) const {
+		return x_.derivative2(t);
 	}
 
-	double dddx(double t) {
-		return x_->derivative3(t);
+	double dddx(double t) const {
+		return x_.derivative3(t);
 	}
 
-	double dy(double t) {
-		return y_->derivative(t);
+	double dy(double t) const {
+		return y_.derivative(t);
 	}
 
-	double ddy(double t) {
-		return y_->derivative2(t);
+	double ddy(double t) const {
+		return y_.derivative2(t);
 	}
 
-	double dddy(double t) {
-		return y_->derivative3(t);
+	double dddy(double t) const {
+		return y_.derivative3(t);
 	}
 
+	double speed(double t) const {
+		double vx = dx(t);
+		double vy = dy(t);
+		return std::sqrt(vx * vx + vy * vy);
+	}
+
+	double gaussLegendre(double t0, double t1);
+	double adaptiveLength(double t0, double t1, double whole, double tolerance, int depth);
+	double pieceLength(double t0, double t1, double tolerance);
+	double paramForLength(double t0, double target, double tolerance);
+
 private:
 	static constexpr int kSamples = 100;
+	static constexpr double kLengthTolerance = 1.0e-9;
+	static constexpr int kMaxLengthDepth = 16;
+	static constexpr int kMaxNewtonSteps = 16;
 
 private:
-	QuinticHermiteSpline* x_;
-	QuinticHermiteSpline* y_;
+	QuinticHermiteSpline x_;
+	QuinticHermiteSpline y_;
 	bool has_step_;
 	double step_;
+	bool has_length_;
+	double length_;
 };
 
@@ -0,0 +1,123 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "TrajectoryCache.h"
+#include "GeneratorBase.h"
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QJsonDocument>
+
+TrajectoryCache::TrajectoryCache(int maxentries) : entries_(maxentries)
+{
+}
+
+QByteArray TrajectoryCache::computeKey(GeneratorType type, std::shared_ptr<RobotPath> path, std::shared_ptr<RobotParams> robot, double timestep, bool arclength)
+{
+	QByteArray data;
+	QDataStream strm(&data, QIODevice::WriteOnly);
+
+	strm.setByteOrder(QDataStream::LittleEndian);
+	strm.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+	strm << static_cast<qint32>(type);
+	strm << static_cast<qint32>(GeneratorBase::Version);
+	strm << timestep;
+	strm << arclength;
+
+	//
+	// The robot, only the fields that are used by the generators
+	//
+	strm << static_cast<qint32>(robot->getDriveType());
+	strm << robot->getLengthUnits();
+	strm << robot->getWeightUnits();
+	strm << robot->getWheelBaseWidth();
+	strm << robot->getWheelBaseLength();
+	strm << robot->getRobotWeight();
+	strm << robot->getMaxVelocity();
+	strm << robot->getMaxAccel();
+
+	//
+	// The path parameters, units, waypoints, and constraints
+	//
+	const PathParameters& params = path->params();
+	strm << path->units();
+	strm << params.startVelocity();
+	strm << params.endVelocity();
+	strm << params.maxVelocity();
+	strm << params.maxAccel();
+
+	strm << static_cast<qint32>(path->size());
+	for (const Pose2dWithRotation& pt : path->waypoints()) {
+		strm << pt.getTranslation().getX();
+		strm << pt.getTranslation().getY();
+		strm << pt.getRotation().getCos();
+		strm << pt.getRotation().getSin();
+		strm << pt.getSwrot().getCos();
+		strm << pt.getSwrot().getSin();
+		strm << pt.getSwrotVelocity();
+	}
+
+	strm << static_cast<qint32>(path->constraints().size());
+	for (auto c : path->constraints()) {
+		strm << QJsonDocument(c->toJSON()).toJson(QJsonDocument::Compact);
+	}
+
+	return QCryptographicHash::hash(data, QCryptographicHash::Sha256);
+}
+
+std::shared_ptr<TrajectoryGroup> TrajectoryCache::find(const QByteArray& key, GeneratorType type, std::shared_ptr<RobotPath> path)
+{
+	auto cached = entries_.find(key);
+	if (cached == nullptr) {
+		return nullptr;
+	}
+
+	//
+	// The cached trajectories are never modified once generation is complete, so
+	// the new group can share them with the group in the cache.
+	//
+	auto group = std::make_shared<TrajectoryGroup>(type, path);
+	copyGroup(cached, group);
+
+	return group;
+}
+
+bool TrajectoryCache::loadFromDisk(const QByteArray& key, std::shared_ptr<TrajectoryGroup> group)
+{
+	auto stored = disk_.load(key, group->type(), group->path());
+	if (stored == nullptr) {
+		return false;
+	}
+
+	copyGroup(stored, group);
+	return true;
+}
+
+void TrajectoryCache::copyGroup(std::shared_ptr<TrajectoryGroup> from, std::shared_ptr<TrajectoryGroup> to)
+{
+	for (const QString& name : from->trajectoryNames()) {
+		to->addTrajectory(from->getTrajectory(name));
+	}
+
+	if (from->hasError()) {
+		to->setErrorMessage(from->errorMessage());
+	}
+}
+
+void TrajectoryCache::insert(const QByteArray& key, std::shared_ptr<TrajectoryGroup> group)
+{
+	entries_.insert(key, group);
+	disk_.save(key, group);
+}
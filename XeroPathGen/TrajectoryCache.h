@@ -0,0 +1,86 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include "GeneratorType.h"
+#include "TrajectoryGroup.h"
+#include "RobotParams.h"
+#include "RobotPath.h"
+#include "TrajectoryDiskCache.h"
+#include "LruCache.h"
+#include <QtCore/QByteArray>
+#include <memory>
+
+//
+// An in memory cache of generated trajectory groups.  The key is a hash of
+// everything that determines the output of the generators: the waypoints,
+// the constraints, the path parameters, the robot, the generator type, the
+// generator version, and the timestep.  Two paths with identical inputs share
+// the same trajectories.  If a disk cache is enabled, entries are also written
+// to disk.  Looking in memory is cheap and is done on the GUI thread, while
+// loading from disk is left to the generator threads.
+//
+class TrajectoryCache
+{
+public:
+	TrajectoryCache(int maxentries = DefaultMaxEntries);
+
+	static QByteArray computeKey(GeneratorType type, std::shared_ptr<RobotPath> path, std::shared_ptr<RobotParams> robot, double timestep, bool arclength);
+
+	//
+	// Returns a new trajectory group for the given path holding the cached
+	// trajectories, or nullptr if the key is not in the memory cache
+	//
+	std::shared_ptr<TrajectoryGroup> find(const QByteArray& key, GeneratorType type, std::shared_ptr<RobotPath> path);
+
+	bool isOnDisk(const QByteArray& key) {
+		return disk_.contains(key);
+	}
+
+	//
+	// Fill the group with the trajectories stored on disk for the key.  Returns false
+	// if the key is not on disk.  This reads the file, so do not call it on the GUI thread.
+	//
+	bool loadFromDisk(const QByteArray& key, std::shared_ptr<TrajectoryGroup> group);
+
+	void insert(const QByteArray& key, std::shared_ptr<TrajectoryGroup> group);
+
+	void clear() {
+		entries_.clear();
+	}
+
+	void enableDiskCache(const QString& dir) {
+		disk_.setDirectory(dir);
+	}
+
+	void clearDiskCache() {
+		disk_.clear();
+	}
+
+	int size() {
+		return entries_.size();
+	}
+
+private:
+	static constexpr int DefaultMaxEntries = 256;
+
+private:
+	static void copyGroup(std::shared_ptr<TrajectoryGroup> from, std::shared_ptr<TrajectoryGroup> to);
+
+private:
+	LruCache<QByteArray, std::shared_ptr<TrajectoryGroup>> entries_;
+	TrajectoryDiskCache disk_;
+};
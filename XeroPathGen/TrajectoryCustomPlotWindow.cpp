@@ -242,13 +242,10 @@ void TrajectoryCustomPlotWindow::insertNode(const QString& node)
 	double minv = std::numeric_limits<double>::max();
 	double maxv = std::numeric_limits<double>::min();
 
-	QVector<double> x, y;
-
-	for (int i = 0; i < traj->size(); i++) {
-		const Pose2dWithTrajectory& pt = (*traj)[i];
-		double time = pt.getField(RobotPath::TimeTag);
-		double value = pt.getField(type);
+	QVector<double> x = traj->column(RobotPath::TimeTag);
+	QVector<double> y = traj->column(type);
 
+	for (double value : y) {
 		if (value > maxv) {
 			maxv = value;
 		}
@@ -256,9 +253,6 @@ void TrajectoryCustomPlotWindow::insertNode(const QString& node)
 		if (value < minv) {
 			minv = value;
 		}
-
-		x.push_back(time);
-		y.push_back(value);
 	}
 
 	auto gr = addGraph(xAxis, myyaxis);
@@ -0,0 +1,333 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "TrajectoryDiskCache.h"
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QPair>
+#include <algorithm>
+
+TrajectoryDiskCache::TrajectoryDiskCache()
+{
+	max_bytes_ = DefaultMaxBytes;
+	total_bytes_ = 0;
+	writer_.setMaxThreadCount(1);
+}
+
+TrajectoryDiskCache::~TrajectoryDiskCache()
+{
+	flush();
+}
+
+void TrajectoryDiskCache::flush()
+{
+	writer_.waitForDone();
+}
+
+void TrajectoryDiskCache::setDirectory(const QString& dir, qint64 maxbytes)
+{
+	QDir dirobj(dir);
+	if (!dirobj.exists() && !dirobj.mkpath(dirobj.absolutePath())) {
+		dir_.clear();
+		return;
+	}
+
+	flush();
+
+	dir_ = dir;
+	max_bytes_ = maxbytes;
+	scan();
+	evict();
+}
+
+void TrajectoryDiskCache::scan()
+{
+	QDir dirobj(dir_);
+	QFileInfoList files = dirobj.entryInfoList(QStringList() << "*.traj", QDir::Files);
+
+	mutex_.lock();
+	index_.clear();
+	total_bytes_ = 0;
+
+	for (const QFileInfo& info : files) {
+		QByteArray key = QByteArray::fromHex(info.completeBaseName().toLatin1());
+		if (key.size() == 0) {
+			continue;
+		}
+
+		Entry entry;
+		entry.size = info.size();
+		entry.used = info.lastModified().toMSecsSinceEpoch();
+		index_.insert(key, entry);
+		total_bytes_ += entry.size;
+	}
+	mutex_.unlock();
+}
+
+bool TrajectoryDiskCache::contains(const QByteArray& key)
+{
+	mutex_.lock();
+	bool ret = index_.contains(key);
+	mutex_.unlock();
+
+	return ret;
+}
+
+QString TrajectoryDiskCache::fileName(const QByteArray& key) const
+{
+	return QDir(dir_).absoluteFilePath(QString::fromLatin1(key.toHex()) + ".traj");
+}
+
+std::shared_ptr<TrajectoryGroup> TrajectoryDiskCache::load(const QByteArray& key, GeneratorType type, std::shared_ptr<RobotPath> path)
+{
+	if (!isEnabled() || !contains(key)) {
+		return nullptr;
+	}
+
+	QFile file(fileName(key));
+	if (!file.open(QIODevice::ReadOnly)) {
+		forget(key);
+		return nullptr;
+	}
+
+	QDataStream strm(&file);
+	strm.setByteOrder(QDataStream::LittleEndian);
+	strm.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+	quint32 magic, version, count;
+	QByteArray storedkey;
+	QString errmsg;
+
+	strm >> magic >> version >> storedkey >> errmsg >> count;
+	if (strm.status() != QDataStream::Ok || magic != FileMagic || version != FileVersion || storedkey != key) {
+		file.close();
+		writer_.start([this, key]() { remove(key); });
+		return nullptr;
+	}
+
+	auto group = std::make_shared<TrajectoryGroup>(type, path);
+	if (errmsg.length() > 0) {
+		group->setErrorMessage(errmsg);
+	}
+
+	for (quint32 i = 0; i < count; i++) {
+		QString name;
+
+		strm >> name;
+		if (strm.status() != QDataStream::Ok) {
+			break;
+		}
+
+		//
+		// The trajectory is stored a column at a time, the same way it is held in memory
+		//
+		std::shared_ptr<PathTrajectory> traj(new PathTrajectory(name));
+		strm >> traj->time_ >> traj->position_ >> traj->velocity_ >> traj->acceleration_;
+		strm >> traj->x_ >> traj->y_ >> traj->heading_cos_ >> traj->heading_sin_;
+		strm >> traj->swrot_cos_ >> traj->swrot_sin_ >> traj->curvature_ >> traj->rotvel_;
+		if (strm.status() != QDataStream::Ok) {
+			break;
+		}
+
+		int npts = traj->time_.size();
+		if (traj->position_.size() != npts || traj->velocity_.size() != npts || traj->acceleration_.size() != npts ||
+			traj->x_.size() != npts || traj->y_.size() != npts || traj->heading_cos_.size() != npts || traj->heading_sin_.size() != npts ||
+			traj->swrot_cos_.size() != npts || traj->swrot_sin_.size() != npts || traj->curvature_.size() != npts || traj->rotvel_.size() != npts) {
+			strm.setStatus(QDataStream::ReadCorruptData);
+			break;
+		}
+
+		traj->findTimeStep();
+		group->addTrajectory(traj);
+	}
+
+	if (strm.status() != QDataStream::Ok) {
+		//
+		// The file is truncated or corrupt, get rid of it
+		//
+		file.close();
+		writer_.start([this, key]() { remove(key); });
+		return nullptr;
+	}
+
+	file.close();
+	touch(key);
+
+	return group;
+}
+
+void TrajectoryDiskCache::touch(const QByteArray& key)
+{
+	//
+	// Mark the file as recently used so it is the last to be evicted, both in the index
+	// and on disk for the next time the directory is scanned
+	//
+	mutex_.lock();
+	auto it = index_.find(key);
+	if (it != index_.end()) {
+		it->used = QDateTime::currentMSecsSinceEpoch();
+	}
+	mutex_.unlock();
+
+	writer_.start([this, key]() {
+		QFile file(fileName(key));
+		if (file.open(QIODevice::ReadWrite)) {
+			file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+			file.close();
+		}
+	});
+}
+
+void TrajectoryDiskCache::remove(const QByteArray& key)
+{
+	QFile::remove(fileName(key));
+	forget(key);
+}
+
+void TrajectoryDiskCache::forget(const QByteArray& key)
+{
+	mutex_.lock();
+	if (index_.contains(key)) {
+		total_bytes_ -= index_.value(key).size;
+		index_.remove(key);
+	}
+	mutex_.unlock();
+}
+
+void TrajectoryDiskCache::save(const QByteArray& key, std::shared_ptr<TrajectoryGroup> group)
+{
+	if (!isEnabled()) {
+		return;
+	}
+
+	//
+	// The key covers every input to the generators, so a file that is already there
+	// holds the same trajectories
+	//
+	if (contains(key)) {
+		touch(key);
+		return;
+	}
+
+	//
+	// A group is not modified once it is generated, so the writer can share it
+	//
+	writer_.start([this, key, group]() { write(key, group); });
+}
+
+void TrajectoryDiskCache::write(const QByteArray& key, std::shared_ptr<TrajectoryGroup> group)
+{
+	QSaveFile file(fileName(key));
+	if (!file.open(QIODevice::WriteOnly)) {
+		return;
+	}
+
+	QDataStream strm(&file);
+	strm.setByteOrder(QDataStream::LittleEndian);
+	strm.setFloatingPointPrecision(QDataStream::DoublePrecision);
+
+	QStringList names = group->trajectoryNames();
+
+	strm << FileMagic << FileVersion << key << group->errorMessage() << static_cast<quint32>(names.size());
+
+	for (const QString& name : names) {
+		auto traj = group->getTrajectory(name);
+
+		strm << name;
+		strm << traj->time_ << traj->position_ << traj->velocity_ << traj->acceleration_;
+		strm << traj->x_ << traj->y_ << traj->heading_cos_ << traj->heading_sin_;
+		strm << traj->swrot_cos_ << traj->swrot_sin_ << traj->curvature_ << traj->rotvel_;
+	}
+
+	if (!file.commit()) {
+		return;
+	}
+
+	mutex_.lock();
+	if (index_.contains(key)) {
+		total_bytes_ -= index_.value(key).size;
+	}
+
+	Entry entry;
+	entry.size = QFileInfo(fileName(key)).size();
+	entry.used = QDateTime::currentMSecsSinceEpoch();
+	index_.insert(key, entry);
+	total_bytes_ += entry.size;
+	mutex_.unlock();
+
+	evict();
+}
+
+void TrajectoryDiskCache::evict()
+{
+	//
+	// Only called on the writer thread, or before it has been given any work
+	//
+	QList<QByteArray> victims;
+
+	mutex_.lock();
+	if (total_bytes_ > max_bytes_) {
+		QList<QPair<qint64, QByteArray>> order;
+		for (auto it = index_.cbegin(); it != index_.cend(); ++it) {
+			order.push_back(qMakePair(it->used, it.key()));
+		}
+		std::sort(order.begin(), order.end());
+
+		//
+		// Oldest first, remove until we are under the cap
+		//
+		for (int i = 0; i < order.size() && total_bytes_ > max_bytes_; i++) {
+			total_bytes_ -= index_.value(order[i].second).size;
+			index_.remove(order[i].second);
+			victims.push_back(order[i].second);
+		}
+	}
+	mutex_.unlock();
+
+	for (const QByteArray& key : victims) {
+		QFile::remove(fileName(key));
+	}
+}
+
+void TrajectoryDiskCache::clear()
+{
+	if (!isEnabled()) {
+		return;
+	}
+
+	mutex_.lock();
+	index_.clear();
+	total_bytes_ = 0;
+	mutex_.unlock();
+
+	//
+	// Queued behind any writes still outstanding so none of them survive the clear
+	//
+	writer_.start([this]() {
+		QDir dirobj(dir_);
+		for (const QFileInfo& info : dirobj.entryInfoList(QStringList() << "*.traj", QDir::Files)) {
+			QFile::remove(info.absoluteFilePath());
+		}
+
+		mutex_.lock();
+		index_.clear();
+		total_bytes_ = 0;
+		mutex_.unlock();
+	});
+}
@@ -0,0 +1,101 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include "GeneratorType.h"
+#include "TrajectoryGroup.h"
+#include "RobotPath.h"
+#include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QThreadPool>
+#include <memory>
+
+//
+// Stores generated trajectory groups on disk so they survive from one session
+// of the program to the next.  Each group is stored in its own file, named by
+// the cache key, in a compact binary form.  When the total size of the files
+// exceeds the size cap, the least recently used files are removed.
+//
+// The directory is scanned once, when it is set, and after that an index of the
+// files held in memory is kept up to date.  Files are written and removed on a
+// thread of their own so saving never blocks the caller.  Loading is done on the
+// calling thread, which should not be the GUI thread.
+//
+class TrajectoryDiskCache
+{
+public:
+	TrajectoryDiskCache();
+	~TrajectoryDiskCache();
+
+	void setDirectory(const QString& dir, qint64 maxbytes = DefaultMaxBytes);
+
+	bool isEnabled() const {
+		return dir_.length() > 0;
+	}
+
+	//
+	// True if a file for the key is on disk, this only looks at the index
+	//
+	bool contains(const QByteArray& key);
+
+	std::shared_ptr<TrajectoryGroup> load(const QByteArray& key, GeneratorType type, std::shared_ptr<RobotPath> path);
+
+	//
+	// Queue the group to be written, a group already on disk is only marked as used
+	//
+	void save(const QByteArray& key, std::shared_ptr<TrajectoryGroup> group);
+
+	void clear();
+
+	//
+	// Wait for any queued writes to finish
+	//
+	void flush();
+
+private:
+	static constexpr qint64 DefaultMaxBytes = 64 * 1024 * 1024;
+	static constexpr quint32 FileMagic = 0x58504754;			// XPGT
+	static constexpr quint32 FileVersion = 2;
+
+	struct Entry
+	{
+		qint64 size;									// The size of the file in bytes
+		qint64 used;									// When the file was last written or read, in ms since the epoch
+	};
+
+private:
+	QString fileName(const QByteArray& key) const;
+	void scan();
+	void write(const QByteArray& key, std::shared_ptr<TrajectoryGroup> group);
+	void touch(const QByteArray& key);
+	void remove(const QByteArray& key);
+	void forget(const QByteArray& key);
+	void evict();
+
+private:
+	QString dir_;
+	qint64 max_bytes_;
+
+	// Guards the index and the total size
+	QMutex mutex_;
+	QMap<QByteArray, Entry> index_;
+	qint64 total_bytes_;
+
+	// A single thread, so files are written and removed in the order requested
+	QThreadPool writer_;
+};
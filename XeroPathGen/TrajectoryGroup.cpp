@@ -15,8 +15,10 @@
 //
 #include "TrajectoryGroup.h"
 
-TrajectoryGroup::TrajectoryGroup(GeneratorType type, std::shared_ptr<RobotPath> path)
+TrajectoryGroup::TrajectoryGroup(GeneratorType type, std::shared_ptr<RobotPath> path, bool preview)
 {
 	type_ = type;
 	path_ = path;
+	preview_ = preview;
+	rotation_percent_ = -1.0;
 }
\ No newline at end of file
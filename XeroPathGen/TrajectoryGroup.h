@@ -18,13 +18,14 @@
 #include "GeneratorType.h"
 #include "RobotPath.h"
 #include "PathTrajectory.h"
+#include "CancelToken.h"
 #include <QtCore/QMap>
 #include <memory>
 
 class TrajectoryGroup 
 {
 public:
-	TrajectoryGroup(GeneratorType type, std::shared_ptr<RobotPath> path);
+	TrajectoryGroup(GeneratorType type, std::shared_ptr<RobotPath> path, bool preview = false);
 
 	std::shared_ptr<RobotPath> path() {
 		return path_;
@@ -34,6 +35,14 @@ public:
 		return type_;
 	}
 
+	//
+	// A preview group is generated at a coarse resolution to give quick feedback
+	// while a path is being edited.  It is never cached or written out.
+	//
+	bool isPreview() const {
+		return preview_;
+	}
+
 	void addTrajectory(std::shared_ptr<PathTrajectory> traj) {
 		trajectories_.insert(traj->name(), traj);
 	}
@@ -56,14 +65,43 @@ public:
 		return err_msg_.length() > 0;
 	}
 
+	const QString& errorMessage() const {
+		return err_msg_;
+	}
+
 	QStringList trajectoryNames() const {
 		return trajectories_.keys();
 	}
 
+	CancelToken& cancelToken() {
+		return cancel_;
+	}
+
+	bool isCanceled() const {
+		return cancel_.isCanceled();
+	}
+
+	//
+	// For a swerve drive with a single rotation, the percentage of the velocity given to
+	// the linear motion.  Before generation this is the value found the last time the
+	// path was generated, if any, and is used as a starting point for the search.  It
+	// is negative if not known.
+	//
+	double rotationPercent() const {
+		return rotation_percent_;
+	}
+
+	void setRotationPercent(double p) {
+		rotation_percent_ = p;
+	}
+
 private:
 	GeneratorType type_;
+	bool preview_;
 	std::shared_ptr<RobotPath> path_;
 	QMap<QString, std::shared_ptr<PathTrajectory>> trajectories_;
 	QString err_msg_;
+	CancelToken cancel_;
+	double rotation_percent_;
 };
 
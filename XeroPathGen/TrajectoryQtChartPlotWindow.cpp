@@ -335,10 +335,11 @@ void TrajectoryQtChartPlotWindow::insertNode(const QString& node)
 	series->setUseOpenGL(true);
 	series->setName(node);
 
-	for (int i = 0; i < traj->size(); i++) {
-		const Pose2dWithTrajectory& pt = (*traj)[i];
-		double time = pt.getField(RobotPath::TimeTag);
-		double value = pt.getField(type);
+	QVector<double> times = traj->column(RobotPath::TimeTag);
+	QVector<double> values = traj->column(type);
+
+	for (int i = 0; i < values.size(); i++) {
+		double value = values[i];
 
 		if (value > maxv) {
 			maxv = value;
@@ -348,7 +349,7 @@ void TrajectoryQtChartPlotWindow::insertNode(const QString& node)
 			minv = value;
 		}
 
-		series->append(time, value);
+		series->append(times[i], value);
 	}
 
 	chart()->addSeries(series);
@@ -15,69 +15,190 @@
 //
 #include "TrajectoryUtils.h"
 #include "RobotPath.h"
+#include <QtCore/QThreadPool>
+#include <QtCore/QThread>
+#include <QtCore/QSemaphore>
+#include <QtCore/QMutex>
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+std::atomic<int> TrajectoryUtils::generating_(0);
+
+static QThreadPool* helperPool()
+{
+	//
+	// A pool of its own, so the splines never wait behind other work in the global pool.  The
+	// calling thread always does some of the work, so one less thread than there are cores is
+	// enough.
+	//
+	static QThreadPool* pool = []() {
+		QThreadPool* p = new QThreadPool();
+		p->setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+		return p;
+	}();
+
+	return pool;
+}
 
 QVector<Pose2dWithRotation> TrajectoryUtils::parameterize(const QVector<std::shared_ptr<SplinePair>>& splines,
-	double maxDx, double maxDy, double maxDTheta)
+	double maxDx, double maxDy, double maxDTheta, const CancelToken* cancel)
 {
+	QVector<QVector<Pose2dWithRotation>> each = parameterizeEach(splines, maxDx, maxDy, maxDTheta, cancel);
 	QVector<Pose2dWithRotation> results;
 
+	//
+	// Each spline starts where the one before it ends, so only the first spline keeps
+	// its start point
+	//
+	int count = 1;
+	for (const QVector<Pose2dWithRotation>& pts : each)
+		count += pts.size() - 1;
+
+	results.reserve(count);
 	results.push_back(splines[0]->getStartPose());
-	for (int i = 0; i < splines.size(); i++)
-		getSegmentArc(splines[i], results, 0.0, 1.0, maxDx, maxDy, maxDTheta);
+	for (const QVector<Pose2dWithRotation>& pts : each) {
+		for (int i = 1; i < pts.size(); i++)
+			results.push_back(pts[i]);
+	}
 
 	return results;
 }
 
-void TrajectoryUtils::getSegmentArc(std::shared_ptr<SplinePair> pair, QVector<Pose2dWithRotation>& results,
-	double t0, double t1, double maxDx, double maxDy, double maxDTheta)
+QVector<QVector<Pose2dWithRotation>> TrajectoryUtils::parameterizeEach(const QVector<std::shared_ptr<SplinePair>>& splines,
+	double maxDx, double maxDy, double maxDTheta, const CancelToken* cancel)
 {
-	const Translation2d& p0 = pair->evalPosition(t0);
-	const Translation2d& p1 = pair->evalPosition(t1);
-	const Rotation2d& r0 = pair->evalHeading(t0);
-	const Rotation2d& r1 = pair->evalHeading(t1);
-	Pose2d transformation = Pose2d(Translation2d(p0, p1).rotateBy(r0.inverse()), r1.rotateBy(r0.inverse()));
-	Twist2d twist = Pose2d::logfn(transformation);
-	if (twist.getY() > maxDy || twist.getX() > maxDx || twist.getTheta() > maxDTheta) {
-		getSegmentArc(pair, results, t0, (t0 + t1) / 2, maxDx, maxDy, maxDTheta);
-		getSegmentArc(pair, results, (t0 + t1) / 2, t1, maxDx, maxDy, maxDTheta);
+	QVector<QVector<Pose2dWithRotation>> results(splines.size());
+	QVector<Pose2dWithRotation>* out = results.data();
+
+	//
+	// The splines are handed out one at a time to this thread and to any helper thread
+	// that is free right now.  A thread that is not free is not waited for, so this
+	// never stalls behind work started by another generator.
+	//
+	std::atomic<int> next(0);
+	std::atomic<bool> stop(false);
+	std::exception_ptr error;
+	QMutex errorlock;
+
+	//
+	// Nothing escapes from the work, so every helper releases the semaphore.  The first
+	// exception stops the other threads and is thrown again once they are done.
+	//
+	auto work = [&]() {
+		std::vector<ArcInterval> stack;
+		int i;
+		while (!stop.load() && (i = next.fetch_add(1)) < splines.size()) {
+			try {
+				out[i] = parameterize(*splines[i], maxDx, maxDy, maxDTheta, stack, cancel);
+			}
+			catch (...) {
+				errorlock.lock();
+				if (error == nullptr)
+					error = std::current_exception();
+				errorlock.unlock();
+				stop.store(true);
+			}
+		}
+	};
+
+	//
+	// Each other thread generating a path is already using a core, so it is not
+	// borrowed for the splines
+	//
+	int others = std::max(0, generating_.load() - 1);
+	int wanted = std::min(static_cast<int>(splines.size()) - 1, QThread::idealThreadCount() - 1 - others);
+
+	QSemaphore done;
+	int helpers = 0;
+
+	QThreadPool* pool = helperPool();
+	for (int i = 0; i < wanted; i++) {
+		if (!pool->tryStart([&]() { work(); done.release(); })) {
+			break;
+		}
+		helpers++;
 	}
-	else {
-		results.push_back(pair->evalPose(t1));
+
+	work();
+	done.acquire(helpers);
+
+	if (error != nullptr) {
+		std::rethrow_exception(error);
 	}
+
+	return results;
 }
 
-double TrajectoryUtils::rotationalToLinear(std::shared_ptr<RobotParams> robot, double rv)
+QVector<Pose2dWithRotation> TrajectoryUtils::parameterize(std::shared_ptr<SplinePair> spline,
+	double maxDx, double maxDy, double maxDTheta, const CancelToken* cancel)
 {
-	double diameter = std::sqrt(robot->getWheelBaseWidth() * robot->getWheelBaseWidth() + robot->getWheelBaseLength() * robot->getWheelBaseLength());
-	double circum = diameter * MathUtils::kPI;
-	return rv * circum / 360.0;
+	std::vector<ArcInterval> stack;
+	return parameterize(*spline, maxDx, maxDy, maxDTheta, stack, cancel);
 }
 
-double TrajectoryUtils::linearToRotational(std::shared_ptr<RobotParams> robot, double gr)
+QVector<Pose2dWithRotation> TrajectoryUtils::parameterize(const SplinePair& spline, double maxDx, double maxDy, double maxDTheta,
+	std::vector<ArcInterval>& stack, const CancelToken* cancel)
 {
-	double diameter = std::sqrt(robot->getWheelBaseWidth() * robot->getWheelBaseWidth() + robot->getWheelBaseLength() * robot->getWheelBaseLength());
-	double circum = diameter * MathUtils::kPI;
-	return gr * 360.0 / circum;
+	QVector<Pose2dWithRotation> results;
+
+	results.push_back(spline.getStartPose());
+	getSegmentArc(spline, results, maxDx, maxDy, maxDTheta, stack, cancel);
+
+	return results;
 }
 
-void TrajectoryUtils::computeCurvature(std::shared_ptr<PathTrajectory> traj)
+void TrajectoryUtils::getSegmentArc(const SplinePair& pair, QVector<Pose2dWithRotation>& results,
+	double maxDx, double maxDy, double maxDTheta, std::vector<ArcInterval>& stack, const CancelToken* cancel)
 {
-	double curv;
+	//
+	// Each interval on the stack holds the position and heading at both of its ends, so
+	// every parameter is only evaluated once.  The second half of a split interval is
+	// pushed first, so the points come out in the same order as a depth first recursion.
+	// A cancel can leave intervals behind, so the stack is cleared first.
+	//
+	stack.clear();
+	stack.reserve(kArcStackSize);
+	stack.push_back({ 0.0, 1.0, pair.evalPosition(0.0), pair.evalPosition(1.0), pair.evalHeading(0.0), pair.evalHeading(1.0) });
+
+	while (!stack.empty())
+	{
+		if (cancel != nullptr) {
+			cancel->throwIfCanceled();
+		}
 
-	auto pts = *traj;
-	for (int i = 0; i < traj->size(); i++) {
-		if (i == 0 || i == traj->size() - 1)
-		{
-			curv = 0.0;
+		ArcInterval iv = stack.back();
+		stack.pop_back();
+
+		Pose2d transformation = Pose2d(Translation2d(iv.p0, iv.p1).rotateBy(iv.r0.inverse()), iv.r1.rotateBy(iv.r0.inverse()));
+		Twist2d twist = Pose2d::logfn(transformation);
+		if (twist.getY() > maxDy || twist.getX() > maxDx || twist.getTheta() > maxDTheta) {
+			double tm = (iv.t0 + iv.t1) / 2;
+			Translation2d pm = pair.evalPosition(tm);
+			Rotation2d rm = pair.evalHeading(tm);
+
+			stack.push_back({ tm, iv.t1, pm, iv.p1, rm, iv.r1 });
+			stack.push_back({ iv.t0, tm, iv.p0, pm, iv.r0, rm });
 		}
-		else
-		{
-			curv = Pose2dWithRotation::curvature(pts[i - 1].pose(), pts[i].pose(), pts[i + 1].pose());
-			pts[i].pose().setCurvature(curv);
+		else {
+			results.push_back(Pose2d(iv.p1, iv.r1));
 		}
 	}
 }
 
+double TrajectoryUtils::rotationalToLinear(std::shared_ptr<RobotParams> robot, double rv)
+{
+	double diameter = std::sqrt(robot->getWheelBaseWidth() * robot->getWheelBaseWidth() + robot->getWheelBaseLength() * robot->getWheelBaseLength());
+	double circum = diameter * MathUtils::kPI;
+	return rv * circum / 360.0;
+}
+
+double TrajectoryUtils::linearToRotational(std::shared_ptr<RobotParams> robot, double gr)
+{
+	double diameter = std::sqrt(robot->getWheelBaseWidth() * robot->getWheelBaseWidth() + robot->getWheelBaseLength() * robot->getWheelBaseLength());
+	double circum = diameter * MathUtils::kPI;
+	return gr * 360.0 / circum;
+}
 
 void TrajectoryUtils::computeCurvature(QVector<Pose2dWithRotation>& pts)
 {
@@ -101,28 +222,12 @@ QVector<double> TrajectoryUtils::getDistancesForSplines(const QVector<std::share
 	QVector<double> dists;
 
 	if (splines.length() > 0) {
-		int steps = 10000;
 		double dist = 0;
 
 		dists.push_back(0.0);
 		for (int i = 0; i < splines.size(); i++)
 		{
-			auto pair = splines[i];
-			bool first = true;
-			Translation2d pos, prevpos;
-			for (float t = 0.0f; t <= 1.0f; t += 1.0f / steps)
-			{
-				pos = pair->evalPosition(t);
-				if (first)
-					first = false;
-				else
-				{
-					dist += pos.distance(prevpos);
-				}
-
-				prevpos = pos;
-			}
-
+			dist += splines[i]->length();
 			dists.push_back(dist);
 		}
 	}
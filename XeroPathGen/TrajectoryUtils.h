@@ -19,7 +19,10 @@
 #include "Pose2dWithRotation.h"
 #include "RobotParams.h"
 #include "PathTrajectory.h"
+#include "CancelToken.h"
 #include <QtCore/QVector>
+#include <atomic>
+#include <vector>
 
 class TrajectoryUtils
 {
@@ -28,19 +31,70 @@ public:
 	~TrajectoryUtils() = delete;
 
 	static QVector<Pose2dWithRotation> parameterize(const QVector<std::shared_ptr<SplinePair>>& splines,
-		double maxDx, double maxDy, double maxDTheta);
+		double maxDx, double maxDy, double maxDTheta, const CancelToken* cancel = nullptr);
+
+	//
+	// The points for a single spline, including both ends
+	//
+	static QVector<Pose2dWithRotation> parameterize(std::shared_ptr<SplinePair> spline,
+		double maxDx, double maxDy, double maxDTheta, const CancelToken* cancel = nullptr);
+
+	//
+	// The points for each spline, including both ends, with the splines parameterized in parallel.
+	// An exception from any spline is thrown again on the calling thread.
+	//
+	static QVector<QVector<Pose2dWithRotation>> parameterizeEach(const QVector<std::shared_ptr<SplinePair>>& splines,
+		double maxDx, double maxDy, double maxDTheta, const CancelToken* cancel = nullptr);
 
 	static double linearToRotational(std::shared_ptr<RobotParams> robot, double v);
 	static double rotationalToLinear(std::shared_ptr<RobotParams> robot, double v);
 
-	static void computeCurvature(std::shared_ptr<PathTrajectory> traj);
-
 	static void computeCurvature(QVector<Pose2dWithRotation>& points);
 
 	static QVector<double> getDistancesForSplines(const QVector<std::shared_ptr<SplinePair>>& splines);
 
+	//
+	// Counts the calling thread as generating a path for as long as this exists.
+	// parameterizeEach() only borrows the cores that no other generating thread is
+	// using, so a busy generation manager does not run more threads than there are cores.
+	//
+	class GeneratingThread
+	{
+	public:
+		GeneratingThread() {
+			generating_.fetch_add(1);
+		}
+
+		~GeneratingThread() {
+			generating_.fetch_sub(1);
+		}
+	};
+
 private:
-	static void getSegmentArc(std::shared_ptr<SplinePair> pair, QVector<Pose2dWithRotation>& results,
-		double t0, double t1, double maxDx, double maxDy, double maxDTheta);
+	//
+	// An interval of a spline waiting to be checked by getSegmentArc(), with the position
+	// and heading at both of its ends
+	//
+	struct ArcInterval
+	{
+		double t0, t1;
+		Translation2d p0, p1;
+		Rotation2d r0, r1;
+	};
+
+	//
+	// As parameterize() for a single spline, using stack for the intervals so a thread
+	// that parameterizes many splines reuses it
+	//
+	static QVector<Pose2dWithRotation> parameterize(const SplinePair& spline, double maxDx, double maxDy, double maxDTheta,
+		std::vector<ArcInterval>& stack, const CancelToken* cancel);
+
+	static void getSegmentArc(const SplinePair& pair, QVector<Pose2dWithRotation>& results,
+		double maxDx, double maxDy, double maxDTheta, std::vector<ArcInterval>& stack, const CancelToken* cancel);
+
+private:
+	static constexpr int kArcStackSize = 64;
+
+	static std::atomic<int> generating_;
 };
 
@@ -0,0 +1,60 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "TrajectoryWriter.h"
+#include "PathGroup.h"
+#include "CSVWriter.h"
+#include <QtCore/QDir>
+#include <fstream>
+
+bool TrajectoryWriter::write(const QString& outdir, std::shared_ptr<RobotPath> path, std::shared_ptr<TrajectoryGroup> group)
+{
+	QVector<QString> headers =
+	{
+		RobotPath::TimeTag,
+		RobotPath::XTag,
+		RobotPath::YTag,
+		RobotPath::PositionTag,
+		RobotPath::VelocityTag,
+		RobotPath::AccelerationTag,
+		RobotPath::HeadingTag,
+		RobotPath::CurvatureTag,
+		RobotPath::RotationTag,
+	};
+
+	bool ret = true;
+
+	for (const QString& name : group->trajectoryNames())
+	{
+		auto traj = group->getTrajectory(name);
+		QDir dirobj = QDir(outdir);
+		QString filename = dirobj.absoluteFilePath(path->pathGroup()->name() + "-" + path->name() + "-" + name + ".csv");
+
+		std::ofstream outstrm(filename.toStdString());
+		if (!outstrm.is_open()) {
+			ret = false;
+			continue;
+		}
+
+		QVector<QVector<double>> columns;
+		for (const QString& header : headers) {
+			columns.push_back(traj->column(header));
+		}
+
+		CSVWriter::writeColumns(outstrm, headers, columns);
+	}
+
+	return ret;
+}
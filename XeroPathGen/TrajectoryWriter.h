@@ -0,0 +1,34 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include "RobotPath.h"
+#include "TrajectoryGroup.h"
+#include <QtCore/QString>
+#include <memory>
+
+//
+// Writes the trajectories for a path to CSV files, one file per trajectory in
+// the group, named <group>-<path>-<trajectory>.csv
+//
+class TrajectoryWriter
+{
+public:
+	TrajectoryWriter() = delete;
+	~TrajectoryWriter() = delete;
+
+	static bool write(const QString& outdir, std::shared_ptr<RobotPath> path, std::shared_ptr<TrajectoryGroup> group);
+};
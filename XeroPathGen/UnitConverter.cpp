@@ -17,125 +17,89 @@
 #include <stdexcept>
 #include <algorithm>
 
-UnitConverter::conversion UnitConverter::convert_[] =
+constexpr UnitConverter::unitinfo UnitConverter::units_[] =
 {
-	{ "ft", "in", 12.0, UnitConverter::UnitType::Length},
-	{ "in", "cm", 2.54, UnitConverter::UnitType::Length},
-	{ "in", "m", 0.0254, UnitConverter::UnitType::Length},
-	{ "m", "ft", 3.28084, UnitConverter::UnitType::Length},
-	{ "ft", "cm", 30.48, UnitConverter::UnitType::Length},
-	{ "m", "cm", 100.0, UnitConverter::UnitType::Length},
-
-	{ "lbs", "kg", 0.453592, UnitConverter::UnitType::Weight},
-};
-
-QString UnitConverter::normalizeUnits(const QString& units)
-{
-	QString ret = units;
-
-	if (units == "meters")
-		ret = "m";
-	else if (units == "feet")
-		ret = "ft";
-	else if (units == "foot")
-		ret = "ft";
-	else if (units == "inches")
-		ret = "in";
+	{ UnitConverter::Unit::Inches, "in", 0.0254, UnitConverter::UnitType::Length},
+	{ UnitConverter::Unit::Feet, "ft", 0.3048, UnitConverter::UnitType::Length},
+	{ UnitConverter::Unit::Centimeters, "cm", 0.01, UnitConverter::UnitType::Length},
+	{ UnitConverter::Unit::Meters, "m", 1.0, UnitConverter::UnitType::Length},
 
-	return ret;
-}
+	{ UnitConverter::Unit::Kilograms, "kg", 1.0, UnitConverter::UnitType::Weight},
+	{ UnitConverter::Unit::Pounds, "lbs", 0.453592, UnitConverter::UnitType::Weight},
+};
 
-bool UnitConverter::findConversion(const QString& from, const QString& to, double& conversion)
+constexpr UnitConverter::factortable UnitConverter::buildFactors()
 {
-	bool ret = false;
+	factortable factors{};
 
-	QString fromnorm = normalizeUnits(from);
-	QString tonorm = normalizeUnits(to);
+	//
+	// Any unit converts to itself, even one that is not known, so a value that is already
+	// in the units asked for is never an error
+	//
+	for (int i = 0; i < UnitCount; i++)
+		factors.value[i][i] = 1.0;
 
-	if (fromnorm == tonorm)
-	{
-		conversion = 1.0;
-		ret = true;
-	}
-	else
+	for (const unitinfo& from : units_)
 	{
-		for (int i = 0; i < sizeof(convert_) / sizeof(convert_[0]); i++)
+		for (const unitinfo& to : units_)
 		{
-			if (fromnorm == convert_[i].from && tonorm == convert_[i].to)
-			{
-				conversion = convert_[i].conversion;
-				ret = true;
-				break;
-			}
-
-			if (tonorm == convert_[i].from && fromnorm == convert_[i].to)
-			{
-				conversion = 1.0 / convert_[i].conversion;
-				ret = true;
-				break;
-			}
+			if (from.type_ == to.type_ && from.unit != to.unit)
+				factors.value[static_cast<int>(from.unit)][static_cast<int>(to.unit)] = from.base / to.base;
 		}
 	}
 
-	return ret;
+	return factors;
 }
 
-double UnitConverter::convert(double value, const QString& from, const QString& to)
-{
-	double conv;
+constexpr UnitConverter::factortable UnitConverter::factors_ = UnitConverter::buildFactors();
 
-	if (from == to)
-		return value;
+UnitConverter::Unit UnitConverter::toUnit(const QString& units)
+{
+	if (units == "meters")
+		return Unit::Meters;
+	else if (units == "feet" || units == "foot")
+		return Unit::Feet;
+	else if (units == "inches")
+		return Unit::Inches;
 
-	if (!findConversion(from, to, conv))
+	for (const unitinfo& info : units_)
 	{
-		QString msg = "no conversion from '";
-		msg += from;
-		msg += "' to '";
-		msg += to;
-		msg += "'";
-		throw std::runtime_error(msg.toStdString());
+		if (units == info.name)
+			return info.unit;
 	}
 
-	return value * conv;
+	return Unit::Unknown;
 }
 
-float UnitConverter::convert(float value, const QString& from, const QString& to)
+QString UnitConverter::toString(Unit unit)
 {
-	double conv;
-
-	if (!findConversion(from, to, conv))
+	for (const unitinfo& info : units_)
 	{
-		QString msg = "no conversion from '";
-		msg += from;
-		msg += "' to '";
-		msg += to;
-		msg += "'";
-		throw std::runtime_error(msg.toStdString());
+		if (unit == info.unit)
+			return info.name;
 	}
 
-	return static_cast<float>(value * conv);
+	return "unknown";
 }
 
-bool UnitConverter::hasConversion(const QString& from, const QString& to)
+void UnitConverter::noConversion(Unit from, Unit to)
 {
-	double conv;
-	return findConversion(from, to, conv);
+	QString msg = "no conversion from '";
+	msg += toString(from);
+	msg += "' to '";
+	msg += toString(to);
+	msg += "'";
+	throw std::runtime_error(msg.toStdString());
 }
 
 QList<QString> UnitConverter::getAllLengthUnits()
 {
 	QList<QString> result;
 
-	for (int i = 0; i < sizeof(convert_) / sizeof(convert_[0]); i++)
+	for (const unitinfo& info : units_)
 	{
-		if (convert_[i].type_ == UnitType::Length)
-		{
-			if (std::find(result.begin(), result.end(), convert_[i].to) == result.end())
-				result.push_back(convert_[i].to);
-			if (std::find(result.begin(), result.end(), convert_[i].from) == result.end())
-				result.push_back(convert_[i].from);
-		}
+		if (info.type_ == UnitType::Length)
+			result.push_back(info.name);
 	}
 
 	return result;
@@ -145,16 +109,11 @@ QList<QString> UnitConverter::getAllWeightUnits()
 {
 	QList<QString> result;
 
-	for (int i = 0; i < sizeof(convert_) / sizeof(convert_[0]); i++)
+	for (const unitinfo& info : units_)
 	{
-		if (convert_[i].type_ == UnitType::Weight)
-		{
-			if (std::find(result.begin(), result.end(), convert_[i].to) == result.end())
-				result.push_back(convert_[i].to);
-			if (std::find(result.begin(), result.end(), convert_[i].from) == result.end())
-				result.push_back(convert_[i].from);
-		}
+		if (info.type_ == UnitType::Weight)
+			result.push_back(info.name);
 	}
 
 	return result;
-}
+}
\ No newline at end of file
@@ -20,29 +20,61 @@
 
 class UnitConverter
 {
+public:
+	/// \brief the units the converter can process
+	enum class Unit
+	{
+		Inches,
+		Feet,
+		Centimeters,
+		Meters,
+		Kilograms,
+		Pounds,
+		Unknown,
+	};
+
 public:
 	UnitConverter() = delete;
 	~UnitConverter() = delete;
 
-	/// \brief convert a double value from one set of units to another
+	/// \brief convert a double value from one unit to another
 	/// \param value the value to convert
-	/// \param from the units to convert from
-	/// \param to the units to convert to
-	/// \returns value converted to new units
-	static double convert(double value, const QString& from, const QString& to);
+	/// \param from the unit to convert from
+	/// \param to the unit to convert to
+	/// \returns value converted to the new unit
+	static double convert(double value, Unit from, Unit to) {
+		return value * factor(from, to);
+	}
 
-	/// \brief convert a double value from one set of units to another
-	/// \param value the value to convert
-	/// \param from the units to convert from
-	/// \param to the units to convert to
-	/// \return value converted to new units
-	static float convert(float value, const QString& from, const QString& to);
+	/// \brief returns the value to multiply by to convert from one unit to another
+	/// \param from the unit to convert from
+	/// \param to the unit to convert to
+	/// \returns the conversion factor, throws if there is no conversion
+	static double factor(Unit from, Unit to) {
+		double ret = factors_.value[static_cast<int>(from)][static_cast<int>(to)];
+		if (ret == 0.0)
+			noConversion(from, to);
+
+		return ret;
+	}
+
+	/// \brief returns the unit for a units string, including the long names like 'meters'
+	/// \param units the units string
+	/// \returns the unit, or Unit::Unknown if the units are not known
+	static Unit toUnit(const QString& units);
+
+	/// \brief returns the short name for a unit, as stored in files
+	/// \param unit the unit
+	/// \returns the name of the unit
+	static QString toString(Unit unit);
 
 	/// \brief returns information about whether a conversion is possible
-	/// \param from the units to convert from
-	/// \param to the units to convert to
+	/// \param from the unit to convert from
+	/// \param to the unit to convert to
 	/// \returns true if the conversion is possible, false otherwise
-	static bool hasConversion(const QString& from, const QString& to);
+	static bool hasConversion(Unit from, Unit to) {
+		return factors_.value[static_cast<int>(from)][static_cast<int>(to)] != 0.0;
+	}
 
 	/// \brief returns all units the converter can process
 	/// \returns a list of all units the converter can process
@@ -53,9 +85,6 @@ public:
 	/// \returns a list of all units the converter can process
 	static QList<QString> getAllWeightUnits();
 
-private:
-	static QString normalizeUnits(const QString& units);
-
 private:
 	enum class UnitType
 	{
@@ -64,15 +93,35 @@ private:
 	};
 
 private:
-	struct conversion
+	static constexpr int UnitCount = static_cast<int>(Unit::Unknown) + 1;
+
+	//
+	// One entry per unit, giving the size of the unit in meters or kilograms.  A
+	// new unit only needs an entry here.
+	//
+	struct unitinfo
 	{
-		const char* from;
-		const char* to;
-		double conversion;
+		Unit unit;
+		const char* name;
+		double base;
 		UnitType type_;
 	};
 
-	static bool findConversion(const QString& from, const QString& to, double& conversion);
-	static struct conversion convert_[];
+	// value[from][to] is the factor from one unit to another, or zero if there is no conversion
+	struct factortable
+	{
+		double value[UnitCount][UnitCount];
+	};
+
+	[[noreturn]] static void noConversion(Unit from, Unit to);
+	static constexpr factortable buildFactors();
+
+	static const unitinfo units_[];
+
+	//
+	// Computed by the compiler, so the table is complete before any dynamic initialization
+	// and a static initializer in another file can convert units safely
+	//
+	static const factortable factors_;
 };
 
@@ -14,7 +14,6 @@
 // limitations under the License.
 //
 #include "XeroPathGen.h"
-#include "CSVWriter.h"
 #include "PropertyEditor.h"
 #include "EditableProperty.h"
 #include "DriveBaseData.h"
@@ -34,6 +33,7 @@
 #include "UndoRemovePoint.h"
 #include "UndoRenameGroup.h"
 #include "UndoRenamePath.h"
+#include "TrajectoryWriter.h"
 #include <QtCore/QCoreApplication>
 #include <QtWidgets/QDockWidget>
 #include <QtWidgets/QMenu>
@@ -42,6 +42,7 @@
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QStatusBar>
 #include <QtWidgets/QLabel>
+#include <QtWidgets/QProgressBar>
 #include <QtGui/QCloseEvent>
 #include <QtGui/QActionGroup>
 #include <fstream>
@@ -80,6 +81,18 @@ XeroPathGen::XeroPathGen(const QStringList &arglist, RobotManager& robots, GameF
 		custom_plot_ = settings_.value("plottype").toBool();
 	}
 
+	if (settings_.contains(GenerationDebounceSetting)) {
+		generator_.setDebounceInterval(settings_.value(GenerationDebounceSetting).toInt());
+	}
+
+	if (settings_.contains(GenerationLazySetting)) {
+		generator_.setLazy(settings_.value(GenerationLazySetting).toBool());
+	}
+
+	if (settings_.contains(GenerationArcLengthSetting)) {
+		generator_.setArcLengthSampling(settings_.value(GenerationArcLengthSetting).toBool());
+	}
+
 	createWindows();
 	createMenus();
 	createToolbar();
@@ -167,7 +180,7 @@ void XeroPathGen::setUnits(const QString& units)
 	//
 	// Set everything else to use these units
 	//
-	fields_.convert(units);
+	fields_.convert(UnitConverter::toUnit(units));
 	path_edit_win_->setUnits(units);
 	path_win_->setUnits(units);
 
@@ -303,6 +316,14 @@ bool XeroPathGen::createMenus()
 	(void)connect(action, &QAction::triggered, this, &XeroPathGen::fileGenerateAs);
 	action = file_menu_->addAction(tr("Generate Paths"));
 	(void)connect(action, &QAction::triggered, this, &XeroPathGen::fileGenerate);
+	action = file_menu_->addAction(tr("Generate Visible Paths Only"));
+	action->setCheckable(true);
+	action->setChecked(generator_.isLazy());
+	(void)connect(action, &QAction::triggered, this, &XeroPathGen::lazyGeneration);
+	action = file_menu_->addAction(tr("Sample Splines By Arc Length"));
+	action->setCheckable(true);
+	action->setChecked(generator_.isArcLengthSampling());
+	(void)connect(action, &QAction::triggered, this, &XeroPathGen::arcLengthSampling);
 	file_menu_->addSeparator();
 	recent_menu_ = file_menu_->addMenu("Recent Files");
 	recent_project_menu_ = file_menu_->addMenu("Recent Projects");
@@ -371,6 +392,27 @@ void XeroPathGen::qtChartPlots()
 	}
 }
 
+void XeroPathGen::lazyGeneration(bool checked)
+{
+	settings_.setValue(GenerationLazySetting, checked);
+	generator_.setLazy(checked);
+
+	if (!checked) {
+		generator_.demandAll();
+	}
+}
+
+void XeroPathGen::arcLengthSampling(bool checked)
+{
+	settings_.setValue(GenerationArcLengthSetting, checked);
+	generator_.setArcLengthSampling(checked);
+
+	//
+	// Every trajectory was sampled the other way, so generate them all again
+	//
+	trajectoryGeneratorChanged();
+}
+
 bool XeroPathGen::createToolbar()
 {
 	return true;
@@ -390,6 +432,12 @@ bool XeroPathGen::createStatusBar()
 	path_gendir_ = new QLabel("<unknown>");
 	statusBar()->addPermanentWidget(path_gendir_);
 
+	generate_progress_ = new QProgressBar();
+	generate_progress_->setMaximumWidth(200);
+	generate_progress_->setFormat("Generating %v/%m");
+	generate_progress_->hide();
+	statusBar()->addPermanentWidget(generate_progress_);
+
 	updateStatusBar();
 
 	return true;
@@ -728,42 +776,72 @@ void XeroPathGen::fileGenerate()
 			}
 		}
 
-		updateAllPaths(true);
-
 		//
-		// Now all paths have been processed
+		// Each path is written out as soon as its trajectories are ready.  An export still
+		// running is replaced by this one, which writes every path, so it is not reported
+		// as stopped.
 		//
-		for (auto path : paths_data_model_.getAllPaths()) {
-			auto trajgrp = generator_.getTrajectoryGroup(path);
-			generateOnePath(path, trajgrp);
+		if (export_batch_ != nullptr) {
+			export_batch_->disconnect(this);
+			export_batch_ = nullptr;
 		}
+
+		generator_.clear();
+		export_batch_ = generator_.addPaths(paths_data_model_.generatorType(), paths_data_model_.getAllPaths());
+
+		generate_progress_->setRange(0, export_batch_->total());
+		generate_progress_->setValue(0);
+		generate_progress_->show();
+
+		(void)connect(export_batch_.get(), &GenerationBatch::pathComplete, this, &XeroPathGen::exportPathComplete);
+		(void)connect(export_batch_.get(), &GenerationBatch::progress, generate_progress_, [this](int completed, int total) { generate_progress_->setValue(completed); });
+		(void)connect(export_batch_.get(), &GenerationBatch::finished, this, &XeroPathGen::exportDone);
+		(void)connect(export_batch_.get(), &GenerationBatch::canceled, this, &XeroPathGen::exportCanceled);
 	}
 }
 
-void XeroPathGen::generateOnePath(std::shared_ptr<RobotPath> path, std::shared_ptr<TrajectoryGroup> group)
+void XeroPathGen::exportPathComplete(std::shared_ptr<RobotPath> path)
 {
-	QVector<QString> headers =
-	{
-		RobotPath::TimeTag,
-		RobotPath::XTag,
-		RobotPath::YTag,
-		RobotPath::PositionTag,
-		RobotPath::VelocityTag,
-		RobotPath::AccelerationTag,
-		RobotPath::HeadingTag,
-		RobotPath::CurvatureTag,
-		RobotPath::RotationTag,
-	};
-
-	for (const QString& name : group->trajectoryNames())
-	{
-		auto traj = group->getTrajectory(name);
-		QDir dirobj = QDir(paths_data_model_.outputDir());
-		QString filename = dirobj.absoluteFilePath(path->pathGroup()->name() + "-" + path->name() + "-" + name + ".csv");
+	auto trajgrp = generator_.getTrajectoryGroup(path);
+	if (trajgrp != nullptr) {
+		generateOnePath(path, trajgrp);
+	}
+}
+
+void XeroPathGen::exportDone()
+{
+	generate_progress_->hide();
+	export_batch_ = nullptr;
+}
 
-		std::ofstream outstrm(filename.toStdString());
-		CSVWriter::write<QVector<Pose2dWithTrajectory>::const_iterator>(outstrm, headers, traj->begin(), traj->end());
+void XeroPathGen::exportCanceled()
+{
+	QStringList missing;
+	for (auto path : export_batch_->remaining()) {
+		missing.push_back(path->fullname());
 	}
+
+	generate_progress_->hide();
+	export_batch_ = nullptr;
+
+	//
+	// The export is canceled from inside whatever cleared the generator, such as a change
+	// to the robot, so ask the user once that has finished
+	//
+	QMetaObject::invokeMethod(this, [this, missing]() {
+		QString msg = "Path generation stopped before every path was written.  These paths were not written:\n\n";
+		msg += missing.join("\n");
+		msg += "\n\nDo you want to generate the paths again?";
+
+		if (QMessageBox::question(this, "Generation Stopped", msg) == QMessageBox::Yes) {
+			fileGenerate();
+		}
+	}, Qt::QueuedConnection);
+}
+
+void XeroPathGen::generateOnePath(std::shared_ptr<RobotPath> path, std::shared_ptr<TrajectoryGroup> group)
+{
+	TrajectoryWriter::write(paths_data_model_.outputDir(), path, group);
 }
 
 void XeroPathGen::updateStatusBar()
@@ -795,7 +873,7 @@ void XeroPathGen::updateStatusBar()
 	}
 }
 
-void XeroPathGen::updateAllPaths(bool wait)
+void XeroPathGen::updateAllPaths()
 {
 	generator_.clear();
 
@@ -803,13 +881,6 @@ void XeroPathGen::updateAllPaths(bool wait)
 	{
 		generator_.addPath(paths_data_model_.generatorType(), path);
 	}
-
-	if (wait) {
-		while (!generator_.isEmpty()) {
-			QCoreApplication::processEvents();
-			QThread::msleep(10);
-		}
-	}
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -953,6 +1024,18 @@ void XeroPathGen::setDefaultField()
 //
 void XeroPathGen::setPath(std::shared_ptr<RobotPath> path)
 {
+	//
+	// Generate the selected path first, and then the other paths in its group as
+	// those are the ones shown next to it in the path window
+	//
+	generator_.setSelectedPath(path);
+	if (path != nullptr && path->pathGroup() != nullptr) {
+		generator_.setVisiblePaths(path->pathGroup()->paths());
+	}
+	else {
+		generator_.setVisiblePaths(QList<std::shared_ptr<RobotPath>>());
+	}
+
 	auto trajgrp = generator_.getTrajectoryGroup(path);
 
 	path_edit_win_->setPath(path);
@@ -1118,14 +1201,14 @@ void XeroPathGen::newRobotSelected(std::shared_ptr<RobotParams> robot)
 void XeroPathGen::newRobotAction()
 {
 	createEditRobot(nullptr, "");
-	updateAllPaths(false);
+	updateAllPaths();
 }
 
 void XeroPathGen::editRobotAction()
 {
 	createEditRobot(current_robot_, "");
 	setRobot(current_robot_) ;
-	updateAllPaths(false);
+	updateAllPaths();
 }
 
 void XeroPathGen::showRobotMenu()
@@ -1222,7 +1305,7 @@ void XeroPathGen::waypointSelected(int index)
 
 void XeroPathGen::waypointStartMoving(int index)
 {
-	paths_data_model_.enableGeneration(false);
+	paths_data_model_.enablePreview(true);
 	waypoint_win_->refresh();
 }
 
@@ -1233,7 +1316,7 @@ void XeroPathGen::waypointMoving(int index)
 
 void XeroPathGen::waypointEndMoving(int index)
 {
-	paths_data_model_.enableGeneration(true);
+	paths_data_model_.enablePreview(false);
 	waypoint_win_->refresh();
 }
 
@@ -1504,7 +1587,7 @@ void XeroPathGen::trajectoryGeneratorChanged()
 	// reflect the udpated data
 	//
 	setPath(path_edit_win_->getPath());
-	updateAllPaths(false);
+	updateAllPaths();
 }
 
 void XeroPathGen::trajectoryGenerationComplete(std::shared_ptr<RobotPath> path)
@@ -1526,9 +1609,8 @@ void XeroPathGen::sliderChanged(int value)
 	if (trajgrp != nullptr) {
 		auto traj = trajgrp->getTrajectory(TrajectoryName::Main);
 		if (traj) {
-			int index = traj->getIndex(time);
-			if (index >= 0 && index < traj->size()) {
-				const Pose2dWithTrajectory& pose = (*traj)[index];
+			if (traj->size() > 0 && time >= traj->times().front() && time <= traj->getEndTime()) {
+				Pose2dWithTrajectory pose = traj->sample(time);
 				text += ",  X: " + QString::number(pose.translation().getX(), 'f', 2);
 				text += ",  Y: " + QString::number(pose.translation().getY(), 'f', 2);
 				text += ",  Heading: " + QString::number(pose.rotation().toDegrees(), 'f', 2);
@@ -30,6 +30,7 @@
 #include "ConstraintEditorWindow.h"
 #include <QtWidgets/QMainWindow>
 #include <QtWidgets/QLabel>
+#include <QtWidgets/QProgressBar>
 #include <QtCore/QSettings>
 #include <fstream>
 #include <sstream>
@@ -79,6 +80,9 @@ private:
     static constexpr const char* WindowStateSetting = "windowState";
     static constexpr const char* PlotWindowSplitterSize = "plotWindowSplitterSize";
     static constexpr const char* PlotWindowNodeList = "plotWindowNodeList";
+    static constexpr const char* GenerationDebounceSetting = "generationDebounce";
+    static constexpr const char* GenerationLazySetting = "generationLazy";
+    static constexpr const char* GenerationArcLengthSetting = "generationArcLength";
 
 private:
     void setDefaultField();
@@ -116,7 +120,10 @@ private:
 
     void generateOnePath(std::shared_ptr<RobotPath> path, std::shared_ptr<TrajectoryGroup> group);
     void updateStatusBar();
-    void updateAllPaths(bool wait);
+    void updateAllPaths();
+    void exportPathComplete(std::shared_ptr<RobotPath> path);
+    void exportDone();
+    void exportCanceled();
     void createEditRobot(std::shared_ptr<RobotParams> robot, const QString &path);
 
     void showAbout();
@@ -131,6 +138,8 @@ private:
 
     void customPlotPlots();
     void qtChartPlots();
+    void lazyGeneration(bool checked);
+    void arcLengthSampling(bool checked);
 
 private:
     static constexpr const char* RobotDialogName = "Name";
@@ -161,6 +170,9 @@ private:
     std::shared_ptr<GameField> current_field_;
     std::shared_ptr<RobotParams> current_robot_;
 
+    // The paths being generated for export, if any
+    std::shared_ptr<GenerationBatch> export_batch_;
+
     std::stringstream& strstream_;
 
     // Windows
@@ -205,6 +217,7 @@ private:
     QLabel* time_text_;
     QLabel* path_filename_;
     QLabel* path_gendir_;
+    QProgressBar* generate_progress_;
 
     RecentFiles* recents_;
     RecentFiles* project_recents_;
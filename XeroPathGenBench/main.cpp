@@ -0,0 +1,255 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "TestPaths.h"
+#include "Generator.h"
+#include "TrajectoryGroup.h"
+#include "TrajectoryNames.h"
+#include "TrajectoryUtils.h"
+#include "CSVWriter.h"
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonArray>
+#include <QtCore/QFile>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+//
+// Times each stage of trajectory generation on its own, on a fixed set of
+// paths, and prints the results as JSON so that runs can be compared.
+//
+
+using namespace TestPaths;
+
+namespace
+{
+	struct Result
+	{
+		QString path;
+		QString stage;
+		qint64 iterations;
+		double nsPerOp;
+		double pointsPerSec;
+	};
+
+	class Bench
+	{
+	public:
+		Bench(double mintime) {
+			mintime_ = mintime;
+		}
+
+		//
+		// Runs the operation until at least mintime seconds have gone by, after one
+		// untimed warm up run.  The operation returns the number of points it produced.
+		//
+		void run(const QString& path, const QString& stage, std::function<int()> op) {
+			int points = op();
+			qint64 iterations = 0;
+			double elapsed = 0.0;
+			qint64 total = 0;
+
+			auto start = std::chrono::steady_clock::now();
+			while (elapsed < mintime_) {
+				total += op();
+				iterations++;
+				elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			}
+
+			Result r;
+			r.path = path;
+			r.stage = stage;
+			r.iterations = iterations;
+			r.nsPerOp = elapsed * 1.0e9 / iterations;
+			r.pointsPerSec = (points > 0) ? total / elapsed : 0.0;
+			results_.push_back(r);
+
+			std::cerr << path.toStdString() << " " << stage.toStdString() << ": " << r.nsPerOp << " ns/op" << std::endl;
+		}
+
+		QJsonArray toJSON() const {
+			QJsonArray arr;
+
+			for (const Result& r : results_) {
+				QJsonObject obj;
+				obj["path"] = r.path;
+				obj["stage"] = r.stage;
+				obj["iterations"] = r.iterations;
+				obj["ns_per_op"] = r.nsPerOp;
+				obj["points_per_sec"] = r.pointsPerSec;
+				arr.append(obj);
+			}
+
+			return arr;
+		}
+
+	private:
+		double mintime_;
+		QVector<Result> results_;
+	};
+
+	//
+	// The corpus: a short path, a long winding path, and a path that asks a swerve
+	// drive to rotate a lot between waypoints
+	//
+	QVector<std::shared_ptr<RobotPath>> createCorpus(const PathGroup* group)
+	{
+		QVector<std::shared_ptr<RobotPath>> paths;
+
+		paths.push_back(createPath(group, "short", {
+			waypoint(0.0, 0.0, 0.0),
+			waypoint(2.0, 0.5, 0.0),
+		}));
+
+		paths.push_back(createPath(group, "long", {
+			waypoint(0.0, 0.0, 0.0),
+			waypoint(3.0, 1.5, 45.0),
+			waypoint(6.0, 3.0, 0.0),
+			waypoint(9.0, 1.5, -45.0),
+			waypoint(12.0, 0.0, 0.0),
+			waypoint(15.0, 1.5, 45.0),
+			waypoint(16.0, 4.0, 90.0),
+			waypoint(14.0, 6.0, 180.0),
+		}));
+
+		paths.push_back(createPath(group, "rotation", rotationWaypoints()));
+
+		return paths;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	QCoreApplication app(argc, argv);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Time each stage of trajectory generation");
+	parser.addHelpOption();
+
+	QCommandLineOption mintime(QStringList() << "t" << "time", "the minimum time in seconds to run each benchmark", "seconds", "0.5");
+	parser.addOption(mintime);
+	QCommandLineOption output(QStringList() << "o" << "output", "the file to write the JSON results to, defaults to standard output", "file");
+	parser.addOption(output);
+	parser.process(app);
+
+	QTemporaryDir tmpdir;
+	QString logfile = tmpdir.path() + "/generators_log.txt";
+	QMutex loglock;
+
+	Bench bench(parser.value(mintime).toDouble());
+
+	PathGroup group("bench");
+	auto tank = createRobot(RobotParams::DriveType::TankDrive);
+	auto swerve = createRobot(RobotParams::DriveType::SwerveDrive);
+
+	for (auto path : createCorpus(&group)) {
+		const QString& name = path->name();
+		StageGenerator gen(logfile, loglock, tank, false);
+		gen.computeRobotParameters(path);
+
+		auto splines = gen.generateSplines(path->waypoints());
+		bench.run(name, "generateSplines", [&]() {
+			return gen.generateSplines(path->waypoints()).size();
+		});
+
+		auto params = TrajectoryUtils::parameterize(splines, MaxDx, MaxDy, MaxDTheta);
+		bench.run(name, "parameterize", [&]() {
+			return TrajectoryUtils::parameterize(splines, MaxDx, MaxDy, MaxDTheta).size();
+		});
+
+		DistanceView view(params, Diststep);
+		bench.run(name, "DistanceView", [&]() {
+			DistanceView v(params, Diststep);
+			return v.size();
+		});
+
+		bench.run(name, "sampleArcLength", [&]() {
+			return gen.sampleArcLength(path, Diststep).size();
+		});
+
+		const PathParameters& pp = path->params();
+		QVector<std::shared_ptr<PathConstraint>> constraints = path->constraints();
+		auto timed = gen.timeParameterize(view, constraints, pp.startVelocity(), pp.endVelocity(), pp.maxVelocity(), pp.maxAccel());
+		bench.run(name, "timeParameterize", [&]() {
+			return gen.timeParameterize(view, constraints, pp.startVelocity(), pp.endVelocity(), pp.maxVelocity(), pp.maxAccel()).size();
+		});
+
+		auto uniform = gen.convertToUniformTime(timed, Timestep);
+		bench.run(name, "convertToUniformTime", [&]() {
+			return gen.convertToUniformTime(timed, Timestep).size();
+		});
+
+		auto traj = std::make_shared<PathTrajectory>(TrajectoryName::Main, uniform);
+
+		bench.run(name, "addTankDriveTrajectories", [&]() {
+			auto trajgrp = std::make_shared<TrajectoryGroup>(GeneratorType::CheesyPoofs, path);
+			trajgrp->addTrajectory(traj);
+			Generator::addTankDriveTrajectories(tank, path->unit(), trajgrp);
+			return 2 * traj->size();
+		});
+
+		QVector<QString> headers = {
+			RobotPath::TimeTag, RobotPath::XTag, RobotPath::YTag, RobotPath::PositionTag, RobotPath::VelocityTag,
+			RobotPath::AccelerationTag, RobotPath::HeadingTag, RobotPath::CurvatureTag, RobotPath::RotationTag,
+		};
+		bench.run(name, "CSVWriter::writeColumns", [&]() {
+			std::ostringstream strm;
+			QVector<QVector<double>> columns;
+			for (const QString& header : headers) {
+				columns.push_back(traj->column(header));
+			}
+			CSVWriter::writeColumns(strm, headers, columns);
+			return traj->size();
+		});
+
+		StageGenerator single(logfile, loglock, swerve, false);
+		single.computeRobotParameters(path);
+		bench.run(name, "generateSwerveSingleRotate", [&]() {
+			auto t = single.generateSwerveSingleRotate(path);
+			return (t == nullptr) ? 0 : t->size();
+		});
+
+		StageGenerator perwaypoint(logfile, loglock, swerve, true);
+		perwaypoint.computeRobotParameters(path);
+		bench.run(name, "generateSwervePerWaypointRotate", [&]() {
+			auto t = perwaypoint.generateSwervePerWaypointRotate(path);
+			return (t == nullptr) ? 0 : t->size();
+		});
+	}
+
+	QJsonObject obj;
+	obj["min_time"] = parser.value(mintime).toDouble();
+	obj["results"] = bench.toJSON();
+	QByteArray json = QJsonDocument(obj).toJson();
+
+	if (parser.isSet(output)) {
+		QFile file(parser.value(output));
+		if (!file.open(QIODevice::WriteOnly)) {
+			std::cerr << "xeropathgen-bench: cannot write '" << parser.value(output).toStdString() << "'" << std::endl;
+			return 1;
+		}
+		file.write(json);
+	}
+	else {
+		std::cout << json.toStdString();
+	}
+
+	return 0;
+}
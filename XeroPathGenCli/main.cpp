@@ -0,0 +1,128 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "PathsDataModel.h"
+#include "GenerationMgr.h"
+#include "RobotManager.h"
+#include "TrajectoryWriter.h"
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <iostream>
+
+//
+// Generates every path in a path file for a given robot and writes the same
+// CSV files the GUI writes for "Generate Paths".  This needs no display, so it
+// can run in a build pipeline or on the robot laptop.
+//
+int main(int argc, char* argv[])
+{
+	QCoreApplication::setOrganizationName("ErrorCodeXero");
+	QCoreApplication::setOrganizationDomain("www.wilsonvillerobotics.com");
+	QCoreApplication::setApplicationName("XeroPathGenerator");
+	QCoreApplication::setApplicationVersion("1.0.0");
+
+	QCoreApplication app(argc, argv);
+
+	QCommandLineParser parser;
+	parser.setApplicationDescription("Generate the trajectory files for a path file");
+	parser.addHelpOption();
+	parser.addVersionOption();
+	parser.addPositionalArgument("pathfile", "the path file to generate");
+	parser.addPositionalArgument("robotfile", "the robot file (JSON) to generate the paths for");
+
+	QCommandLineOption outdir(QStringList() << "o" << "output", "the directory for the CSV files, defaults to the output directory stored in the path file", "dir");
+	parser.addOption(outdir);
+	QCommandLineOption arclength("arc-length", "sample the splines at equal arc length rather than resampling subdivided points");
+	parser.addOption(arclength);
+	parser.process(app);
+
+	const QStringList args = parser.positionalArguments();
+	if (args.size() != 2) {
+		parser.showHelp(1);
+	}
+
+	//
+	// The generators log to a file in the application data directory, make sure it exists
+	//
+	QStringList dirs = QStandardPaths::standardLocations(QStandardPaths::AppLocalDataLocation);
+	QDir().mkpath(dirs.front());
+
+	RobotManager robots;
+	QFile robotfile(args.at(1));
+	auto robot = robots.load(robotfile);
+	if (robot == nullptr) {
+		std::cerr << "xeropathgen-cli: cannot load robot file '" << args.at(1).toStdString() << "'" << std::endl;
+		return 1;
+	}
+
+	GenerationMgr generator;
+	PathsDataModel model(generator);
+
+	//
+	// Every path is requested at once, there is no editing to wait out
+	//
+	generator.setDebounceInterval(0);
+	generator.setArcLengthSampling(parser.isSet(arclength));
+
+	QString msg;
+	if (!model.load(args.at(0), msg)) {
+		std::cerr << "xeropathgen-cli: " << msg.toStdString() << std::endl;
+		return 1;
+	}
+
+	QString dir = parser.isSet(outdir) ? parser.value(outdir) : model.outputDir();
+	if (dir.length() == 0) {
+		std::cerr << "xeropathgen-cli: the path file has no output directory, use --output" << std::endl;
+		return 1;
+	}
+
+	QDir dirobj(dir);
+	if (!dirobj.exists() && !dirobj.mkpath(dirobj.absolutePath())) {
+		std::cerr << "xeropathgen-cli: cannot create the output directory '" << dir.toStdString() << "'" << std::endl;
+		return 1;
+	}
+
+	if (model.getAllPaths().size() == 0) {
+		return 0;
+	}
+
+	int errors = 0;
+
+	generator.setRobot(robot);
+	auto batch = generator.addPaths(model.generatorType(), model.getAllPaths());
+
+	QObject::connect(batch.get(), &GenerationBatch::pathComplete, &app, [&](std::shared_ptr<RobotPath> path) {
+		auto group = generator.getTrajectoryGroup(path);
+		if (group == nullptr || group->hasError() || group->trajectoryNames().size() == 0) {
+			std::cerr << "xeropathgen-cli: " << path->fullname().toStdString() << ": generation failed" << std::endl;
+			errors++;
+		}
+		else if (!TrajectoryWriter::write(dir, path, group)) {
+			std::cerr << "xeropathgen-cli: " << path->fullname().toStdString() << ": cannot write the CSV files" << std::endl;
+			errors++;
+		}
+		else {
+			std::cout << path->fullname().toStdString() << std::endl;
+		}
+	});
+
+	QObject::connect(batch.get(), &GenerationBatch::finished, &app, [&]() { app.exit(errors > 0 ? 1 : 0); });
+	QObject::connect(batch.get(), &GenerationBatch::canceled, &app, [&]() { app.exit(1); });
+
+	return app.exec();
+}
@@ -0,0 +1,101 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#pragma once
+
+#include "CheesyGenerator.h"
+#include "PathGroup.h"
+#include "RobotPath.h"
+#include "RobotParams.h"
+#include <QtCore/QMutex>
+#include <QtCore/QVector>
+#include <memory>
+
+//
+// The generator settings, robots and paths shared by the tests and the benchmarks, so
+// that both always exercise the same inputs
+//
+namespace TestPaths
+{
+	//
+	// The values Generator::generateTrajectory uses for full quality, in meters
+	//
+	constexpr double Diststep = 0.0254;
+	constexpr double Timestep = 0.02;
+	constexpr double MaxDx = 0.0508;
+	constexpr double MaxDy = 0.0127;
+	constexpr double MaxDTheta = 0.1;
+
+	//
+	// A generator at full quality that gives access to the individual stages of
+	// generateInternal()
+	//
+	class StageGenerator : public CheesyGenerator
+	{
+	public:
+		StageGenerator(const QString& logfile, QMutex& loglock, std::shared_ptr<RobotParams> robot, bool xeromode)
+			: CheesyGenerator(logfile, loglock, 0, Diststep, Timestep, MaxDx, MaxDy, MaxDTheta, robot, xeromode)
+		{
+		}
+
+		using GeneratorBase::computeRobotParameters;
+		using GeneratorBase::generateSplines;
+		using GeneratorBase::timeParameterize;
+		using GeneratorBase::convertToUniformTime;
+		using GeneratorBase::sampleArcLength;
+		using CheesyGenerator::generateSwervePerWaypointRotate;
+		using CheesyGenerator::generateSwerveSingleRotate;
+	};
+
+	inline std::shared_ptr<RobotParams> createRobot(RobotParams::DriveType type)
+	{
+		auto robot = std::make_shared<RobotParams>("test");
+		robot->setDriveType(type);
+		robot->setLengthUnits("m");
+		robot->setWheelBaseWidth(0.6);
+		robot->setWheelBaseLength(0.6);
+		robot->setMaxVelocity(4.0);
+		robot->setMaxAcceleration(3.0);
+		return robot;
+	}
+
+	inline Pose2dWithRotation waypoint(double x, double y, double heading, double swrot = 0.0)
+	{
+		return Pose2dWithRotation(Translation2d(x, y), Rotation2d::fromDegrees(heading), Rotation2d::fromDegrees(swrot));
+	}
+
+	inline std::shared_ptr<RobotPath> createPath(const PathGroup* group, const QString& name, const QVector<Pose2dWithRotation>& pts)
+	{
+		auto path = std::make_shared<RobotPath>(group, "m", name, PathParameters(0.0, 0.0, 3.0, 2.5));
+		for (const Pose2dWithRotation& pt : pts) {
+			path->addWayPoint(pt);
+		}
+		return path;
+	}
+
+	//
+	// A curved path that asks a swerve drive to rotate a lot between each pair of waypoints
+	//
+	inline QVector<Pose2dWithRotation> rotationWaypoints()
+	{
+		return {
+			waypoint(0.0, 0.0, 0.0, 0.0),
+			waypoint(2.0, 1.0, 30.0, 90.0),
+			waypoint(4.0, 1.0, -30.0, 180.0),
+			waypoint(6.0, 0.0, 0.0, 90.0),
+			waypoint(8.0, 0.0, 0.0, 0.0),
+		};
+	}
+}
@@ -0,0 +1,324 @@
+//
+// Copyright 2022 Jack W. Griffin
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+// 
+// http ://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissionsand
+// limitations under the License.
+//
+#include "TestPaths.h"
+#include "CentripetalConstraint.h"
+#include "DistanceVelocityConstraint.h"
+#include "GenerationBatch.h"
+#include "GenerationMgr.h"
+#include "PathTrajectory.h"
+#include "TrajectoryUtils.h"
+#include "UnitConverter.h"
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTemporaryDir>
+#include <iostream>
+#include <cmath>
+
+//
+// Checks of the trajectory generators that do not need a display.  Each test
+// reports what failed, and the program exits with a nonzero status if anything did.
+//
+
+using namespace TestPaths;
+
+namespace
+{
+	int failures = 0;
+
+	void check(bool cond, const std::string& what)
+	{
+		if (!cond) {
+			std::cerr << "FAILED: " << what << std::endl;
+			failures++;
+		}
+	}
+
+	class TestGenerator : public StageGenerator
+	{
+	public:
+		TestGenerator(const QString& logfile, QMutex& loglock, std::shared_ptr<RobotParams> robot, bool xeromode)
+			: StageGenerator(logfile, loglock, robot, xeromode)
+		{
+		}
+
+		//
+		// The search the per waypoint rotation generator used before the percentages were
+		// bisected: every segment starts at full velocity, and each segment that cannot
+		// make its rotation is lowered by one percent until they all can
+		//
+		std::shared_ptr<PathTrajectory> baselinePerWaypointRotate(std::shared_ptr<RobotPath> path) {
+			QVector<std::shared_ptr<SplinePair>> splines = generateSplines(path->waypoints());
+			QVector<double> dists = TrajectoryUtils::getDistancesForSplines(splines);
+			QVector<double> percents(path->size() - 1, 1.0);
+			std::shared_ptr<PathTrajectory> traj;
+
+			bool running = true;
+			while (running) {
+				running = false;
+
+				QVector<std::shared_ptr<PathConstraint>> extras;
+				for (int i = 0; i < path->size() - 1; i++) {
+					extras.push_back(std::make_shared<DistanceVelocityConstraint>(path, dists[i], dists[i + 1], path->params().maxVelocity() * percents[i]));
+				}
+
+				traj = generateInternal(path, extras);
+				if (traj == nullptr) {
+					return nullptr;
+				}
+
+				for (int i = 0; i < path->size() - 1; i++) {
+					double startTime, endTime;
+					if (!traj->getTimeForDistance(dists[i], startTime) || !traj->getTimeForDistance(dists[i + 1], endTime)) {
+						return nullptr;
+					}
+
+					int startIndex = traj->getIndex(startTime);
+					int endIndex = traj->getIndex(endTime);
+					if (startIndex == -1 || endIndex == -1) {
+						return nullptr;
+					}
+
+					if (traj->size() - endIndex < 5) {
+						endIndex = traj->size();
+					}
+
+					const Pose2dWithRotation& start = path->getPoint(i);
+					const Pose2dWithRotation& end = path->getPoint(i + 1);
+					if (!modifySegmentForRotation(path, traj, 1.0 - percents[i], startIndex, endIndex, start.getSwrot().toDegrees(),
+						start.getSwrotVelocity(), end.getSwrot().toDegrees(), end.getSwrotVelocity())) {
+						percents[i] -= 0.01;
+						running = true;
+						if (percents[i] <= 0.0) {
+							return nullptr;
+						}
+					}
+				}
+			}
+
+			return traj;
+		}
+	};
+
+	//
+	// The rotation path, slowed by a centripetal force limit and by a velocity limit over
+	// part of its length
+	//
+	std::shared_ptr<RobotPath> createRotatingPath(const PathGroup* group)
+	{
+		auto path = createPath(group, "rotating", rotationWaypoints());
+		path->addConstraint(std::make_shared<CentripetalConstraint>(path, 200.0), false);
+		path->addConstraint(std::make_shared<DistanceVelocityConstraint>(path, 3.0, 5.0, 1.5), false);
+		return path;
+	}
+
+	//
+	// A trajectory along the x axis with a point at each of the given times, one meter
+	// apart
+	//
+	std::shared_ptr<PathTrajectory> createTimedTrajectory(const QVector<double>& times)
+	{
+		QVector<Pose2dWithTrajectory> pts;
+		for (int i = 0; i < times.size(); i++) {
+			pts.push_back(Pose2dWithTrajectory(waypoint(i, 0.0, 0.0), times[i], i, 1.0, 0.0));
+		}
+
+		return std::make_shared<PathTrajectory>("test", pts);
+	}
+
+	void testTrajectoryIndex()
+	{
+		//
+		// One trajectory with a fixed time step, which finds the index directly, and one
+		// without, which uses the binary search.  The times are exact in binary so the
+		// midpoints between them are exact ties.
+		//
+		const QVector<double> fixed{ 0.0, 0.25, 0.5, 0.75, 1.0 };
+		const QVector<double> varying{ 0.0, 0.25, 0.625, 0.75, 1.25 };
+
+		for (const QVector<double>& times : { fixed, varying }) {
+			auto traj = createTimedTrajectory(times);
+			std::string what = (&times == &fixed) ? "fixed step trajectory: " : "binary search trajectory: ";
+
+			check(traj->getIndex(0.0) == 0, what + "the start time is the first point");
+			check(traj->getIndex(traj->getEndTime()) == traj->size() - 1, what + "the end time is the last point");
+			check(traj->getIndex(-0.001) == -1, what + "a time before the start has no index");
+			check(traj->getIndex(traj->getEndTime() + 0.001) == -1, what + "a time after the end has no index");
+
+			for (int i = 0; i < times.size() - 1; i++) {
+				double mid = (times[i] + times[i + 1]) / 2.0;
+				check(traj->getIndex(mid) == i, what + "on a tie at " + std::to_string(mid) + " the earlier point is the closest");
+				check(traj->getIndex(mid + 0.001) == i + 1, what + "just past the tie at " + std::to_string(mid) + " the later point is the closest");
+			}
+
+			check(traj->sample(-1.0).time() == 0.0, what + "a sample before the start is the first point");
+			check(traj->sample(traj->getEndTime() + 1.0).time() == traj->getEndTime(), what + "a sample after the end is the last point");
+			check(std::fabs(traj->sample(0.125).position() - 0.5) < 1.0e-9, what + "a sample between two points is interpolated");
+		}
+
+		auto empty = createTimedTrajectory(QVector<double>());
+		check(empty->getIndex(0.0) == -1, "empty trajectory: no time has an index");
+	}
+
+	void testUnitConversion()
+	{
+		check(std::fabs(UnitConverter::convert(1.0, UnitConverter::Unit::Feet, UnitConverter::Unit::Inches) - 12.0) < 1.0e-9, "units: one foot is twelve inches");
+		check(!UnitConverter::hasConversion(UnitConverter::Unit::Meters, UnitConverter::Unit::Pounds), "units: a length does not convert to a weight");
+
+		//
+		// A unit that is not known still converts to itself, so a value already in the
+		// units asked for is unchanged
+		//
+		UnitConverter::Unit unknown = UnitConverter::toUnit("furlongs");
+		check(unknown == UnitConverter::Unit::Unknown, "units: an unrecognized name is unknown");
+		check(UnitConverter::hasConversion(unknown, unknown), "units: an unknown unit converts to itself");
+		check(UnitConverter::convert(2.5, unknown, unknown) == 2.5, "units: converting to the same unknown unit does not change the value");
+	}
+
+	void testEmptyBatch()
+	{
+		//
+		// A batch with no paths has nothing to wait for, so it finishes, and one without a
+		// robot can never generate, so it is canceled.  Either way it must signal once the
+		// event loop runs.
+		//
+		for (bool robot : { true, false }) {
+			GenerationMgr generator;
+			if (robot) {
+				generator.setRobot(createRobot(RobotParams::DriveType::TankDrive));
+			}
+
+			bool finished = false;
+			bool canceled = false;
+			auto batch = generator.addPaths(GeneratorType::CheesyPoofs, QVector<std::shared_ptr<RobotPath>>());
+			QObject::connect(batch.get(), &GenerationBatch::finished, [&finished]() { finished = true; });
+			QObject::connect(batch.get(), &GenerationBatch::canceled, [&canceled]() { canceled = true; });
+			QCoreApplication::processEvents();
+
+			std::string what = robot ? "empty batch: " : "empty batch without a robot: ";
+			check(finished == robot, what + (robot ? "finishes" : "does not finish"));
+			check(canceled != robot, what + (robot ? "is not canceled" : "is canceled"));
+		}
+	}
+
+	void testArcLengthSampling(const QString& logfile, QMutex& loglock)
+	{
+		PathGroup group("test");
+		auto path = createRotatingPath(&group);
+		auto robot = createRobot(RobotParams::DriveType::SwerveDrive);
+
+		TestGenerator chord(logfile, loglock, robot, true);
+		auto expected = chord.generate(path);
+
+		TestGenerator arc(logfile, loglock, robot, true);
+		arc.setArcLengthSampling(true);
+		auto traj = arc.generate(path);
+
+		check(expected != nullptr, "arc length sampling: the default sampling finds a trajectory");
+		check(traj != nullptr, "arc length sampling: finds a trajectory");
+		if (expected == nullptr || traj == nullptr) {
+			return;
+		}
+
+		//
+		// Both ways of sampling follow the same splines, so they must agree on the length of
+		// the path and closely on the time it takes
+		//
+		check(std::fabs(traj->getEndDistance() - expected->getEndDistance()) < 0.005 * expected->getEndDistance(),
+			"arc length sampling: the path length " + std::to_string(traj->getEndDistance()) + " m matches the default sampling " + std::to_string(expected->getEndDistance()) + " m");
+		check(std::fabs(traj->getEndTime() - expected->getEndTime()) < 0.02 * expected->getEndTime(),
+			"arc length sampling: the trajectory time " + std::to_string(traj->getEndTime()) + " s matches the default sampling " + std::to_string(expected->getEndTime()) + " s");
+	}
+
+	void testPerWaypointPercentSolver(const QString& logfile, QMutex& loglock)
+	{
+		PathGroup group("test");
+		auto path = createRotatingPath(&group);
+		auto robot = createRobot(RobotParams::DriveType::SwerveDrive);
+
+		TestGenerator gen(logfile, loglock, robot, true);
+		gen.computeRobotParameters(path);
+
+		auto baseline = gen.baselinePerWaypointRotate(path);
+		auto solved = gen.generateSwervePerWaypointRotate(path);
+
+		check(baseline != nullptr, "per waypoint rotation: the baseline search finds a trajectory");
+		check(solved != nullptr, "per waypoint rotation: the solver finds a trajectory");
+		if (baseline == nullptr || solved == nullptr) {
+			return;
+		}
+
+		//
+		// The solver brackets each percentage more closely than the one percent steps of
+		// the baseline, so it must never give a slower trajectory
+		//
+		check(solved->getEndTime() <= baseline->getEndTime() + 1.0e-9,
+			"per waypoint rotation: the solved trajectory " + std::to_string(solved->getEndTime()) + " s is no slower than the baseline " + std::to_string(baseline->getEndTime()) + " s");
+	}
+
+	void testSingleRotateHint(const QString& logfile, QMutex& loglock)
+	{
+		PathGroup group("test");
+		auto path = createRotatingPath(&group);
+		auto robot = createRobot(RobotParams::DriveType::SwerveDrive);
+
+		TestGenerator cold(logfile, loglock, robot, false);
+		cold.computeRobotParameters(path);
+		auto expected = cold.generateSwerveSingleRotate(path);
+
+		check(expected != nullptr, "single rotation: the search finds a trajectory");
+		if (expected == nullptr) {
+			return;
+		}
+
+		//
+		// The hint may only change how long the search takes, so the same percentage must be
+		// found from any starting point
+		//
+		for (double hint : { cold.rotationPercent(), 0.05, 0.5, 0.97, 1.0 }) {
+			TestGenerator warm(logfile, loglock, robot, false);
+			warm.computeRobotParameters(path);
+			warm.setRotationHint(hint);
+
+			auto traj = warm.generateSwerveSingleRotate(path);
+			std::string what = "single rotation: hint " + std::to_string(hint);
+			check(traj != nullptr, what + " finds a trajectory");
+			check(warm.rotationPercent() == cold.rotationPercent(), what + " finds the same percentage as no hint");
+			check(traj != nullptr && traj->getEndTime() == expected->getEndTime(), what + " gives the same trajectory time as no hint");
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	QCoreApplication app(argc, argv);
+	QTemporaryDir tmpdir;
+	QString logfile = tmpdir.path() + "/generators_log.txt";
+	QMutex loglock;
+
+	testTrajectoryIndex();
+	testUnitConversion();
+	testEmptyBatch();
+	testPerWaypointPercentSolver(logfile, loglock);
+	testArcLengthSampling(logfile, loglock);
+	testSingleRotateHint(logfile, loglock);
+
+	if (failures > 0) {
+		std::cerr << failures << " check(s) failed" << std::endl;
+		return 1;
+	}
+
+	std::cerr << "all checks passed" << std::endl;
+	return 0;
+}